@@ -0,0 +1,58 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "UEDebuggerConsoleCommandGroup.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+DEFINE_LOG_CATEGORY_STATIC(LogConsoleCommandGroupManager, Log, All);
+
+static FAutoConsoleCommandWithWorldAndArgs CCmdBenchmarkConsoleCommandGroup(
+	TEXT("UEDebugger.BenchmarkConsoleCommandGroup"),
+	TEXT("Arguments: <ConsoleCommandGroupName> [N]\n")
+	TEXT("Enables and disables the group N times (100 by default) through the console parser, then with the resolved commands, and logs the average cost of a toggle."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			IConsoleCommandGroupObject* Group = Args.IsValidIndex(0) ? IConsoleCommandGroupManager::Get().FindConsoleCommandGroupObject(Args[0]) : nullptr;
+			if (!Group)
+			{
+				UE_LOG(LogConsoleCommandGroupManager, Warning, TEXT("Usage: UEDebugger.BenchmarkConsoleCommandGroup <ConsoleCommandGroupName> [N]"));
+				return;
+			}
+
+			if (!UGameplayStatics::GetPlayerController(World, 0))
+			{
+				UE_LOG(LogConsoleCommandGroupManager, Warning, TEXT("UEDebugger.BenchmarkConsoleCommandGroup needs a player controller, run it in PIE."));
+				return;
+			}
+
+			const int32 NumToggles = Args.IsValidIndex(1) ? FMath::Max(1, FCString::Atoi(*Args[1])) : 100;
+
+			const double ConsoleStartSeconds = FPlatformTime::Seconds();
+			for (int32 ToggleIndex = 0; ToggleIndex < NumToggles; ToggleIndex++)
+			{
+				FConsoleCommandGroupObject::ExecuteConsoleCommands(World, nullptr, Group->ConsoleCommandsToEnable);
+				FConsoleCommandGroupObject::ExecuteConsoleCommands(World, nullptr, Group->ConsoleCommandsToDisable);
+			}
+			const double ConsoleSeconds = FPlatformTime::Seconds() - ConsoleStartSeconds;
+
+			const double ResolvedStartSeconds = FPlatformTime::Seconds();
+			for (int32 ToggleIndex = 0; ToggleIndex < NumToggles; ToggleIndex++)
+			{
+				Group->Enable(World, nullptr);
+				Group->Disable(World, nullptr);
+			}
+			const double ResolvedSeconds = FPlatformTime::Seconds() - ResolvedStartSeconds;
+
+			UE_LOG(LogConsoleCommandGroupManager, Log, TEXT("UEDebugger.BenchmarkConsoleCommandGroup %s (%d + %d commands), %d toggles: console %.2f us/toggle, resolved %.2f us/toggle"),
+				*Group->Name,
+				Group->ConsoleCommandsToEnable.Num(),
+				Group->ConsoleCommandsToDisable.Num(),
+				NumToggles,
+				ConsoleSeconds * 1000000.0 / NumToggles,
+				ResolvedSeconds * 1000000.0 / NumToggles);
+		}));
+
+#endif
@@ -0,0 +1,86 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Stack.h"
+#include "UEDebuggerBPLibrary.h"
+#include "UEDebuggerPinValues.h"
+#include "UEDebuggerScriptStacks.h"
+#include "UEDebuggerAllocationCounter.h"
+
+#if UE_DEBUGGER_WITH_ALLOCATION_COUNTER
+
+static FAutoConsoleCommand CCmdBenchmarkFormatting(
+	TEXT("UEDebugger.BenchmarkFormatting"),
+	TEXT("Arguments: [N]\n")
+	TEXT("Formats a sample breakpoint record N times (10000 by default) with ToLogString/ToScreenString and with a reused TStringBuilder, and logs the time and the number of allocations per record."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 NumRecords = Args.IsValidIndex(0) ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10000;
+
+			FBlueprintExceptionDebugInfo Info;
+			Info.FrameCounter = 123456;
+			Info.FrameCounterString = TEXT("123456");
+			Info.Index = 42;
+			Info.IndexString = TEXT("42");
+			Info.ActiveObjectNameString = TEXT("BP_Enemy_C_3");
+			Info.NodeGraphNameString = TEXT("EventGraph");
+			Info.NodeCustomFullNameString = TEXT("Print String(1234)");
+			Info.OwnerNameString = TEXT("BP_Spawner_C_1");
+
+			// The stack strings are read from an interned stack, as for a real hit.
+			UFunction* StackFunction = UUEDebuggerBPLibrary::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UUEDebuggerBPLibrary, PrintStringToConsole));
+			FFrame StackFrame(GetMutableDefault<UUEDebuggerBPLibrary>(), StackFunction, nullptr);
+			Info.StackId = FUEDebuggerScriptStacks::Get().Intern(StackFrame);
+
+			// Raw pin values, captured from properties of the record itself: a number, a string and an array.
+			const UScriptStruct* InfoStruct = FBlueprintExceptionDebugInfo::StaticStruct();
+			const TArray<FString> SampleItems = { TEXT("BP_Player_C_0"), TEXT("BP_Player_C_1"), TEXT("BP_Player_C_2") };
+			Info.PinValues = MakeShared<FUEDebuggerPinValues>();
+			Info.PinValues->Capture(EUEDebuggerPinKind::Watched, TEXT("Health"), InfoStruct->FindPropertyByName(GET_MEMBER_NAME_CHECKED(FBlueprintExceptionDebugInfo, Index)), &Info.Index);
+			Info.PinValues->Capture(EUEDebuggerPinKind::Watched, TEXT("Target"), InfoStruct->FindPropertyByName(GET_MEMBER_NAME_CHECKED(FBlueprintExceptionDebugInfo, OwnerNameString)), &Info.OwnerNameString);
+			Info.PinValues->Capture(EUEDebuggerPinKind::Input, TEXT("In String"), InfoStruct->FindPropertyByName(GET_MEMBER_NAME_CHECKED(FBlueprintExceptionDebugInfo, NodeCustomFullNameString)), &Info.NodeCustomFullNameString);
+			Info.PinValues->Capture(EUEDebuggerPinKind::Output, TEXT("Targets"), InfoStruct->FindPropertyByName(GET_MEMBER_NAME_CHECKED(FBlueprintExceptionDebugInfo, WatchedPinsStrings)), &SampleItems);
+
+			int32 TotalLength = 0;
+			double StringsSeconds = 0.0;
+			int64 StringsAllocations = 0;
+			double BuilderSeconds = 0.0;
+			int64 BuilderAllocations = 0;
+
+			{
+				FUEDebuggerAllocationCounter AllocationCounter;
+				const double StartSeconds = FPlatformTime::Seconds();
+				for (int32 RecordIndex = 0; RecordIndex < NumRecords; RecordIndex++)
+				{
+					TotalLength += Info.ToLogString().Len() + Info.ToScreenString().Len();
+				}
+				StringsSeconds = FPlatformTime::Seconds() - StartSeconds;
+				StringsAllocations = AllocationCounter.GetNumAllocations();
+			}
+
+			TStringBuilder<4096> LogString;
+			TStringBuilder<1024> ScreenString;
+			{
+				FUEDebuggerAllocationCounter AllocationCounter;
+				const double StartSeconds = FPlatformTime::Seconds();
+				for (int32 RecordIndex = 0; RecordIndex < NumRecords; RecordIndex++)
+				{
+					LogString.Reset();
+					ScreenString.Reset();
+					Info.AppendLogString(LogString);
+					Info.AppendScreenString(ScreenString);
+					TotalLength += LogString.Len() + ScreenString.Len();
+				}
+				BuilderSeconds = FPlatformTime::Seconds() - StartSeconds;
+				BuilderAllocations = AllocationCounter.GetNumAllocations();
+			}
+
+			UE_LOG(LogUEDebuggerPrintStringToConsole, Log, TEXT("UEDebugger.BenchmarkFormatting: %d records, FString %.3fus/record %.2f allocations/record, TStringBuilder %.3fus/record %.2f allocations/record (%d chars)"),
+				NumRecords,
+				StringsSeconds * 1000000.0 / NumRecords, double(StringsAllocations) / NumRecords,
+				BuilderSeconds * 1000000.0 / NumRecords, double(BuilderAllocations) / NumRecords,
+				TotalLength);
+		}));
+
+#endif
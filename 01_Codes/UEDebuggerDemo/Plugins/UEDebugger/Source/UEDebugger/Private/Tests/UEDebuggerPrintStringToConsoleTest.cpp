@@ -0,0 +1,54 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "UEDebugger.h"
+#include "UEDebuggerCategoryFilter.h"
+#include "UEDebuggerAllocationCounter.h"
+
+#if UE_DEBUGGER_WITH_ALLOCATION_COUNTER && !NO_LOGGING
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUEDebuggerPrintStringToConsoleDisabledTest, "UEDebugger.PrintStringToConsole.DisabledCategoryDoesNotAllocate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FUEDebuggerPrintStringToConsoleDisabledTest::RunTest(const FString& Parameters)
+{
+	static const FName CategoryName(TEXT("UEDebugger_AutomationTest"));
+
+	if (!TestTrue(TEXT("The counting allocator is installed"), FUEDebuggerAllocationCounter::IsProxyInstalled()))
+	{
+		return false;
+	}
+
+	// Rebuilt without the Console variable, so its value and its priority are untouched.
+	FPrintStringToConsoleCategoryFilter& CategoryFilter = FPrintStringToConsoleCategoryFilter::Get();
+	CategoryFilter.Rebuild(TEXT("-UEDebugger_AutomationTest"));
+
+	TestFalse(TEXT("The category is disabled"), UUEDebuggerBPLibrary::IsPrintStringToConsoleCategoryEnabled(CategoryName));
+
+	int32 NumEvaluatedArguments = 0;
+	auto EvaluateArgument = [&NumEvaluatedArguments]()
+	{
+		NumEvaluatedArguments++;
+		return NumEvaluatedArguments;
+	};
+
+	const FString StringArgument(TEXT("Argument"));
+	int64 NumAllocations = 0;
+	{
+		FUEDebuggerAllocationCounter AllocationCounter;
+		for (int32 Index = 0; Index < 1000; Index++)
+		{
+			UE_PSTCF(nullptr, CategoryName, TEXT("Disabled %s %d %f"), *FString::Printf(TEXT("%s_%d"), *StringArgument, Index), EvaluateArgument(), 1.0f);
+		}
+		NumAllocations = AllocationCounter.GetNumAllocations();
+	}
+
+	CategoryFilter.Rebuild(IConsoleManager::Get().FindConsoleVariable(TEXT("EnableDebug.PrintStringToConsole"))->GetString());
+
+	TestEqual(TEXT("Allocations of 1000 UE_PSTCF of a disabled category"), NumAllocations, int64(0));
+	TestEqual(TEXT("Evaluated format arguments of a disabled category"), NumEvaluatedArguments, 0);
+	return true;
+}
+
+#endif
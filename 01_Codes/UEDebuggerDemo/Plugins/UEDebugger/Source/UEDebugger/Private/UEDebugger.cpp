@@ -1,20 +1,51 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
 #include "UEDebugger.h"
+#include "Misc/CoreDelegates.h"
+#include "GameFramework/GameModeBase.h"
+#include "UEDebuggerMessageQueue.h"
+#include "UEDebuggerMergedLog.h"
+#include "UEDebuggerConsoleCommandGroup.h"
+#include "UEDebuggerNetComponent.h"
+#include "UEDebuggerAllocationCounter.h"
 
 #define LOCTEXT_NAMESPACE "FUEDebuggerModule"
 
 void FUEDebuggerModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
-	
+	OnEndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FUEDebuggerModule::OnEndFrame);
+	OnGameModePostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddStatic(&UUEDebuggerNetComponent::OnGameModePostLogin);
+
+#if UE_DEBUGGER_WITH_ALLOCATION_COUNTER
+	// Once for the process, the automation tests and the benchmarks count the allocations of their thread through it.
+	FUEDebuggerAllocationCounter::InstallProxy();
+#endif
 }
 
 void FUEDebuggerModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
-	
+	FCoreDelegates::OnEndFrame.Remove(OnEndFrameHandle);
+	OnEndFrameHandle.Reset();
+	FGameModeEvents::GameModePostLoginEvent.Remove(OnGameModePostLoginHandle);
+	OnGameModePostLoginHandle.Reset();
+}
+
+void FUEDebuggerModule::OnEndFrame()
+{
+	// Print the messages queued from worker threads.
+	FUEDebuggerMessageQueue::Get().Drain();
+
+	// Send the batched messages of this frame to the remote clients.
+	UUEDebuggerNetComponent::FlushAllPendingClientMessages();
+
+	// Merge the lines of all PIE instances printed this frame, see "UEDebugger.MergedLog".
+	FUEDebuggerMergedLog::Get().Merge();
+
+	// Disable the console command groups whose window ended, see "UEDebugger.EnableGroupFor".
+	IConsoleCommandGroupManager::Get().Tick();
 }
 
 #undef LOCTEXT_NAMESPACE
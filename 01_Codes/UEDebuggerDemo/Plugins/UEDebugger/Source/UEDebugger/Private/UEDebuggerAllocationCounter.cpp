@@ -0,0 +1,191 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerAllocationCounter.h"
+
+#if UE_DEBUGGER_WITH_ALLOCATION_COUNTER
+
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformMisc.h"
+
+namespace UEDebuggerAllocationCounter
+{
+	/** > 0 while a counter of the thread is in scope. */
+	static thread_local int32 CountingDepth = 0;
+
+	/** Allocations of the thread while CountingDepth > 0. */
+	static thread_local int64 NumAllocations = 0;
+
+	/**
+	 * Forwards everything to the allocator it wraps, and counts the Malloc and Realloc calls of the threads which have a counter in scope.
+	 * Never destroyed: any thread may have read GMalloc and still call it until the end of the process.
+	 */
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+
+		explicit FCountingMalloc(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+		{
+		}
+
+		// FMalloc interface -----------------------------------
+
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			Count();
+			return InnerMalloc->Malloc(Size, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override
+		{
+			Count();
+			return InnerMalloc->TryMalloc(Size, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+		{
+			// A shrink to 0 is a free.
+			if (Size > 0)
+			{
+				Count();
+			}
+			return InnerMalloc->Realloc(Original, Size, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Size, uint32 Alignment) override
+		{
+			if (Size > 0)
+			{
+				Count();
+			}
+			return InnerMalloc->TryRealloc(Original, Size, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Size, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			InnerMalloc->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual void InitializeStatsMetadata() override
+		{
+			InnerMalloc->InitializeStatsMetadata();
+		}
+
+		virtual void UpdateStats() override
+		{
+			InnerMalloc->UpdateStats();
+		}
+
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+		{
+			InnerMalloc->GetAllocatorStats(OutStats);
+		}
+
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+		{
+			InnerMalloc->DumpAllocatorStats(Ar);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return InnerMalloc->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return InnerMalloc->GetDescriptiveName();
+		}
+
+		// ----------------------------------------------------
+
+	private:
+
+		static void Count()
+		{
+			if (CountingDepth > 0)
+			{
+				NumAllocations++;
+			}
+		}
+
+		FMalloc* InnerMalloc;
+	};
+
+	static FCountingMalloc* Proxy = nullptr;
+}
+
+FUEDebuggerAllocationCounter::FUEDebuggerAllocationCounter()
+	: StartNumAllocations(UEDebuggerAllocationCounter::NumAllocations)
+{
+	UEDebuggerAllocationCounter::CountingDepth++;
+}
+
+FUEDebuggerAllocationCounter::~FUEDebuggerAllocationCounter()
+{
+	UEDebuggerAllocationCounter::CountingDepth--;
+}
+
+int64 FUEDebuggerAllocationCounter::GetNumAllocations() const
+{
+	return UEDebuggerAllocationCounter::NumAllocations - StartNumAllocations;
+}
+
+void FUEDebuggerAllocationCounter::Reset()
+{
+	StartNumAllocations = UEDebuggerAllocationCounter::NumAllocations;
+}
+
+void FUEDebuggerAllocationCounter::InstallProxy()
+{
+	check(IsInGameThread());
+	check(GMalloc);
+
+	if (UEDebuggerAllocationCounter::Proxy)
+	{
+		return;
+	}
+
+	// The memory allocated before is freed through the proxy by the allocator which allocated it.
+	UEDebuggerAllocationCounter::Proxy = new UEDebuggerAllocationCounter::FCountingMalloc(GMalloc); // we will leak this
+
+	// The other threads read GMalloc without a lock, the proxy is complete before they can see it.
+	FPlatformMisc::MemoryBarrier();
+	GMalloc = UEDebuggerAllocationCounter::Proxy;
+}
+
+bool FUEDebuggerAllocationCounter::IsProxyInstalled()
+{
+	return UEDebuggerAllocationCounter::Proxy != nullptr;
+}
+
+#endif // UE_DEBUGGER_WITH_ALLOCATION_COUNTER
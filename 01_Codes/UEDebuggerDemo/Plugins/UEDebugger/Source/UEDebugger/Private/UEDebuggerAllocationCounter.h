@@ -0,0 +1,50 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The counting allocator only exists for the automation tests and the benchmarks, never in Shipping. */
+#define UE_DEBUGGER_WITH_ALLOCATION_COUNTER (WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING)
+
+#if UE_DEBUGGER_WITH_ALLOCATION_COUNTER
+
+/**
+ * Counts the allocations made by the current thread while it is in scope, used by the benchmarks and the automation tests
+ * to check that a path does not allocate.
+ *
+ * The counting proxy of GMalloc is installed once for the whole process by FUEDebuggerModule::StartupModule() and never removed,
+ * a counter only switches the counting of its own thread on and off. Counters can be nested.
+ *
+ * {
+ *     FUEDebuggerAllocationCounter AllocationCounter;
+ *     ...
+ *     const int64 NumAllocations = AllocationCounter.GetNumAllocations();
+ * }
+ */
+class FUEDebuggerAllocationCounter
+{
+public:
+
+	FUEDebuggerAllocationCounter();
+
+	~FUEDebuggerAllocationCounter();
+
+	/** Allocations of the thread since the construction or the last Reset(). */
+	int64 GetNumAllocations() const;
+
+	void Reset();
+
+	/** Wraps GMalloc in the counting proxy, once for the process. Game thread only. */
+	static void InstallProxy();
+
+	/** false if InstallProxy() was not called, the counters then count nothing. */
+	static bool IsProxyInstalled();
+
+private:
+
+	/** Allocations counted on the thread when the counter started. */
+	int64 StartNumAllocations;
+};
+
+#endif // UE_DEBUGGER_WITH_ALLOCATION_COUNTER
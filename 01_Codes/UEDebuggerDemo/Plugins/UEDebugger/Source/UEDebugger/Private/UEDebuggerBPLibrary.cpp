@@ -11,182 +11,202 @@
 #include "Misc/ConfigCacheIni.h"
 #include "Engine/Console.h"
 #include "UEDebuggerConsoleCommandGroup.h"
+#include "UEDebuggerCategoryFilter.h"
+#include "UEDebuggerMessageQueue.h"
+#include "UEDebuggerNetComponent.h"
+#include "UEDebuggerScreenMessages.h"
+#include "UEDebuggerMergedLog.h"
+#include "UEDebuggerScriptStacks.h"
 
 DEFINE_LOG_CATEGORY(LogUEDebuggerPrintStringToConsole);
 
-static TAutoConsoleVariable<FString> CVarEnableDebugPrintStringToConsole(
-	TEXT("EnableDebug.PrintStringToConsole"),
-	TEXT("0"),
-	TEXT("Toggle PrintStringToConsole.\n")
-	TEXT(" 0: Disable PrintStringToConsole.\n")
-	TEXT(" 1: Enable PrintStringToConsole.")
-	TEXT(" CategoryName: Enable PrintStringToConsole for specified CategoryName."),
-	ECVF_Default);
-
 static TAutoConsoleCommandGroup CCGStatFPSAndUNIT(
 	TEXT("CCGStatFPSAndUNIT"),
 	{TEXT("stat fps"), TEXT("stat unit") },
 	{TEXT("stat fps"), TEXT("stat unit") });
 
-FString FBlueprintExceptionDebugInfo::ToLogString()
+namespace UEDebuggerFormat
 {
-	FString WatchedPinsString;
-	for (int32 IndexTemp = 0; IndexTemp < WatchedPinsStrings.Num(); IndexTemp++)
+	static void Append(FStringBuilderBase& Builder, const FString& String)
 	{
-		if (IndexTemp == 0)
-		{
-			WatchedPinsString += TEXT("WatchedPins: \n");
-		}
-		WatchedPinsString += WatchedPinsStrings[IndexTemp];
-		if (IndexTemp < WatchedPinsStrings.Num() - 1)
-		{
-			WatchedPinsString += TEXT("\n");
-		}
+		Builder.Append(*String, String.Len());
 	}
 
-	FString InputParametersString;
-	for (int32 IndexTemp = 0; IndexTemp < InputParametersStrings.Num(); IndexTemp++)
+	/** String if set (e.g. read from a trace), else the text Member of the interned stack StackId. */
+	static const FString& GetStackString(const FString& String, uint32 StackId, FString FUEDebuggerScriptStackText::*Member)
 	{
-		if (IndexTemp == 0)
-		{
-			InputParametersString += TEXT("InputParameters: \n");
-		}
-		InputParametersString += InputParametersStrings[IndexTemp];
-		if (IndexTemp < InputParametersStrings.Num() - 1)
-		{
-			InputParametersString += TEXT("\n");
-		}
+		const FUEDebuggerScriptStackText* Text = String.IsEmpty() ? FUEDebuggerScriptStacks::Get().FindText(StackId) : nullptr;
+		return Text ? Text->*Member : String;
 	}
 
-	FString OutputParametersString;
-	for (int32 IndexTemp = 0; IndexTemp < OutputParametersStrings.Num(); IndexTemp++)
+	/** Prefix, then the strings and the pin values of Kind separated by Separator, then Suffix. Nothing if there is none. */
+	static void AppendPins(FStringBuilderBase& Builder, const TArray<FString>& Strings, const FUEDebuggerPinValues* PinValues, EUEDebuggerPinKind Kind, const TCHAR* Prefix, const TCHAR* Separator, const TCHAR* Suffix)
 	{
-		if (IndexTemp == 0)
+		int32 NumAppended = 0;
+
+		for (const FString& String : Strings)
+		{
+			Builder << (NumAppended++ == 0 ? Prefix : Separator);
+			Append(Builder, String);
+		}
+
+		const int32 NumPinValues = PinValues ? PinValues->Num() : 0;
+		for (int32 PinIndex = 0; PinIndex < NumPinValues; PinIndex++)
 		{
-			OutputParametersString += TEXT("OutputParameters: \n");
+			if (PinValues->GetKind(PinIndex) == Kind)
+			{
+				Builder << (NumAppended++ == 0 ? Prefix : Separator);
+				PinValues->AppendPinString(Builder, PinIndex);
+			}
 		}
-		OutputParametersString += OutputParametersStrings[IndexTemp];
-		if (IndexTemp < OutputParametersStrings.Num() - 1)
+
+		if (NumAppended > 0)
 		{
-			OutputParametersString += TEXT("\n");
+			Builder << Suffix;
 		}
 	}
+}
 
-	FString ParametersString;
-	if (!WatchedPinsString.IsEmpty())
-	{
-		ParametersString += TEXT("\n") + WatchedPinsString;
-	}
-	if (!InputParametersString.IsEmpty())
-	{
-		ParametersString += TEXT("\n") + InputParametersString;
-	}
-	if (!OutputParametersString.IsEmpty())
+void FBlueprintExceptionDebugInfo::AppendLogString(FStringBuilderBase& Builder) const
+{
+	using namespace UEDebuggerFormat;
+
+	Builder << TEXT("[");
+	Append(Builder, FrameCounterString);
+	Builder << TEXT("(");
+	Append(Builder, IndexString);
+	Builder << TEXT(")] [");
+	Append(Builder, GetStackString(PreFrameNameString, StackId, &FUEDebuggerScriptStackText::RootDescription));
+	Builder << TEXT(".");
+	Append(Builder, NodeGraphNameString);
+	Builder << TEXT(".\"");
+	Append(Builder, NodeCustomFullNameString);
+	Builder << TEXT("\"] ");
+	if (SuppressedHits > 0)
 	{
-		ParametersString += TEXT("\n") + OutputParametersString;
+		Builder.Appendf(TEXT("(+%lld suppressed) "), SuppressedHits);
 	}
 
-	FString OwnerAndInstigatorInfo;
+	AppendPins(Builder, WatchedPinsStrings, PinValues.Get(), EUEDebuggerPinKind::Watched, TEXT("\nWatchedPins: \n"), TEXT("\n"), TEXT(""));
+	AppendPins(Builder, InputParametersStrings, PinValues.Get(), EUEDebuggerPinKind::Input, TEXT("\nInputParameters: \n"), TEXT("\n"), TEXT(""));
+	AppendPins(Builder, OutputParametersStrings, PinValues.Get(), EUEDebuggerPinKind::Output, TEXT("\nOutputParameters: \n"), TEXT("\n"), TEXT(""));
+
+	Builder << TEXT(" ");
 	if (!OwnerNameString.IsEmpty())
 	{
-		OwnerAndInstigatorInfo = TEXT("\nOwner = \"") + OwnerNameString + TEXT("\"");
+		Builder << TEXT("\nOwner = \"");
+		Append(Builder, OwnerNameString);
+		Builder << TEXT("\"");
 	}
 	if (!InstigatorNameString.IsEmpty())
 	{
-		OwnerAndInstigatorInfo += TEXT("\nInstigator = \"") + InstigatorNameString + TEXT("\"");
+		Builder << TEXT("\nInstigator = \"");
+		Append(Builder, InstigatorNameString);
+		Builder << TEXT("\"");
 	}
 	if (!InstigatorControllerNameString.IsEmpty())
 	{
-		OwnerAndInstigatorInfo += TEXT("\nInstigatorController = \"") + InstigatorControllerNameString + TEXT("\"");
+		Builder << TEXT("\nInstigatorController = \"");
+		Append(Builder, InstigatorControllerNameString);
+		Builder << TEXT("\"");
 	}
 
-	FString ReturnValue = FString::Printf(TEXT("[%s(%s)] [%s.%s.\"%s\"] %s %s\n%s\nStack Trace:\n%s\n\n "),
-		*FrameCounterString,
-		*IndexString,
-		*PreFrameNameString,
-		*NodeGraphNameString,
-		*NodeCustomFullNameString,
-		*ParametersString,
-		*OwnerAndInstigatorInfo,
-		*StackTraceString,
-		*ScriptCallstackString
-	);
-
-	return ReturnValue;
+	Builder << TEXT("\n");
+	Append(Builder, GetStackString(StackTraceString, StackId, &FUEDebuggerScriptStackText::StackTrace));
+	Builder << TEXT("\nStack Trace:\n");
+	Append(Builder, GetStackString(ScriptCallstackString, StackId, &FUEDebuggerScriptStackText::ScriptCallstack));
+	Builder << TEXT("\n\n ");
 }
 
-FString FBlueprintExceptionDebugInfo::ToScreenString()
+void FBlueprintExceptionDebugInfo::AppendScreenString(FStringBuilderBase& Builder) const
 {
-	FString WatchedPinsString;
-	for (int32 IndexTemp = 0; IndexTemp < WatchedPinsStrings.Num(); IndexTemp++)
+	using namespace UEDebuggerFormat;
+
+	// Name of the function of the previous frame, without its class.
+	const FString& PreFrameName = GetStackString(PreFrameNameString, StackId, &FUEDebuggerScriptStackText::RootDescription);
+	int32 DotIndex = INDEX_NONE;
+	const bool bHasDot = PreFrameName.FindChar(TEXT('.'), DotIndex);
+
+	Builder << TEXT("[");
+	Append(Builder, FrameCounterString);
+	Builder << TEXT("(");
+	Append(Builder, IndexString);
+	Builder << TEXT(")]> [");
+	Append(Builder, ActiveObjectNameString);
+	Builder << TEXT(".");
+	if (bHasDot)
 	{
-		if (IndexTemp == 0)
-		{
-			WatchedPinsString += TEXT("Watched:{ ");
-		}
-		WatchedPinsString += WatchedPinsStrings[IndexTemp];
-		if (IndexTemp < WatchedPinsStrings.Num() - 1)
-		{
-			WatchedPinsString += TEXT("; ");
-		}
-		else
-		{
-			WatchedPinsString += TEXT("}");
-		}
+		Builder.Append(*PreFrameName + DotIndex + 1, PreFrameName.Len() - DotIndex - 1);
+	}
+	Builder << TEXT(".");
+	Append(Builder, NodeGraphNameString);
+	Builder << TEXT(".\"");
+	Append(Builder, NodeCustomFullNameString);
+	Builder << TEXT("\"] ");
+	if (SuppressedHits > 0)
+	{
+		Builder.Appendf(TEXT("(+%lld suppressed) "), SuppressedHits);
 	}
 
-	FString InputParametersString;
-	for (int32 IndexTemp = 0; IndexTemp < InputParametersStrings.Num(); IndexTemp++)
+	AppendPins(Builder, WatchedPinsStrings, PinValues.Get(), EUEDebuggerPinKind::Watched, TEXT("Watched:{ "), TEXT("; "), TEXT("}"));
+	Builder << TEXT(" ");
+	AppendPins(Builder, InputParametersStrings, PinValues.Get(), EUEDebuggerPinKind::Input, TEXT("Input:{ "), TEXT("; "), TEXT("}"));
+	Builder << TEXT(" ");
+	AppendPins(Builder, OutputParametersStrings, PinValues.Get(), EUEDebuggerPinKind::Output, TEXT("Output:{ "), TEXT("; "), TEXT("}"));
+}
+
+FString FBlueprintExceptionDebugInfo::ToLogString() const
+{
+	TStringBuilder<2048> Builder;
+	AppendLogString(Builder);
+	return FString(Builder.Len(), Builder.GetData());
+}
+
+FString FBlueprintExceptionDebugInfo::ToScreenString() const
+{
+	TStringBuilder<512> Builder;
+	AppendScreenString(Builder);
+	return FString(Builder.Len(), Builder.GetData());
+}
+
+void FBlueprintExceptionDebugInfo::ConvertPinValuesToStrings()
+{
+	if (!PinValues.IsValid())
 	{
-		if (IndexTemp == 0)
-		{
-			InputParametersString += TEXT("Input:{ ");
-		}
-		InputParametersString += InputParametersStrings[IndexTemp];
-		if (IndexTemp < InputParametersStrings.Num() - 1)
-		{
-			InputParametersString += TEXT("; ");
-		}
-		else
-		{
-			InputParametersString += TEXT("}");
-		}
+		return;
 	}
 
-	FString OutputParametersString;
-	for (int32 IndexTemp = 0; IndexTemp < OutputParametersStrings.Num(); IndexTemp++)
+	for (int32 PinIndex = 0; PinIndex < PinValues->Num(); PinIndex++)
 	{
-		if (IndexTemp == 0)
-		{
-			OutputParametersString += TEXT("Output:{ ");
-		}
-		OutputParametersString += OutputParametersStrings[IndexTemp];
-		if (IndexTemp < OutputParametersStrings.Num() - 1)
+		switch (PinValues->GetKind(PinIndex))
 		{
-			OutputParametersString += TEXT("; ");
-		}
-		else
-		{
-			OutputParametersString += TEXT("}");
+		case EUEDebuggerPinKind::Watched:
+			WatchedPinsStrings.Add(PinValues->ToPinString(PinIndex));
+			break;
+		case EUEDebuggerPinKind::Input:
+			InputParametersStrings.Add(PinValues->ToPinString(PinIndex));
+			break;
+		case EUEDebuggerPinKind::Output:
+			OutputParametersStrings.Add(PinValues->ToPinString(PinIndex));
+			break;
 		}
 	}
 
-	FString PreFrameNameLeftString;
-	FString PreFrameNameRightString;
-	PreFrameNameString.Split(TEXT("."), &PreFrameNameLeftString, &PreFrameNameRightString);
-
-	FString ReturnValue = FString::Printf(TEXT("[%s(%s)]> [%s.%s.%s.\"%s\"] %s %s %s"),
-		*FrameCounterString,
-		*IndexString,
-		*ActiveObjectNameString,
-		*PreFrameNameRightString,
-		*NodeGraphNameString,
-		*NodeCustomFullNameString,
-		*WatchedPinsString,
-		*InputParametersString,
-		*OutputParametersString
-	);
-	return ReturnValue;
+	PinValues.Reset();
+}
+
+void FBlueprintExceptionDebugInfo::ConvertScriptStackToStrings()
+{
+	const FUEDebuggerScriptStackText* Text = FUEDebuggerScriptStacks::Get().FindText(StackId);
+	if (!Text)
+	{
+		return;
+	}
+
+	PreFrameNameString = Text->RootDescription;
+	StackTraceString = Text->StackTrace;
+	ScriptCallstackString = Text->ScriptCallstack;
+	StackDescriptionString = Text->StackDescription;
 }
 
 UUEDebuggerBPLibrary::UUEDebuggerBPLibrary(const FObjectInitializer& ObjectInitializer)
@@ -198,22 +218,36 @@ UUEDebuggerBPLibrary::UUEDebuggerBPLibrary(const FObjectInitializer& ObjectIniti
 void UUEDebuggerBPLibrary::PrintStringToConsole(UObject* WorldContextObject, const FString& InString, bool bPrintToConsole, bool bPrintToScreen, bool bPrintToLog, FLinearColor TextColor, float Duration, const FName& CategoryName)
 {
 #if !NO_LOGGING
-	static const auto* CVar = IConsoleManager::Get().FindConsoleVariable(TEXT("EnableDebug.PrintStringToConsole"));
-	if (!CVar)
+	if (!IsPrintStringToConsoleCategoryEnabled(CategoryName))
 	{
 		return;
 	}
 
-	FString ValueOfCVar = CVar->GetString().TrimStartAndEnd().ToUpper();
-
-	if (!(ValueOfCVar.Equals(TEXT("1")) || ValueOfCVar.Equals(TEXT("TRUE")) || ValueOfCVar.Equals(CategoryName.ToString().TrimStartAndEnd().ToUpper())))
+	// Not safe out of the game thread, queued and printed at the end of the frame.
+	if (!IsInGameThread())
 	{
+		FUEDebuggerQueuedMessage Message;
+		Message.WorldContextObject = WorldContextObject;
+		Message.Message = InString;
+		Message.CategoryName = CategoryName;
+		Message.TextColor = TextColor;
+		Message.Duration = Duration;
+		Message.bPrintToConsole = bPrintToConsole;
+		Message.bPrintToScreen = bPrintToScreen;
+		Message.bPrintToLog = bPrintToLog;
+		FUEDebuggerMessageQueue::Get().Enqueue(MoveTemp(Message));
 		return;
 	}
 
+	// false if only remote clients subscribed to this category.
+	const bool bCategoryEnabled = FPrintStringToConsoleCategoryFilter::Get().IsCategoryEnabled(CategoryName);
+
 	FString StringWithPrefix = TEXT("[") + CategoryName.ToString() + TEXT("] ") + InString;
 	
-	UUEDebuggerBPLibrary::CustomPrintString(WorldContextObject, StringWithPrefix, bPrintToScreen, bPrintToLog, TextColor, Duration);
+	if (bCategoryEnabled)
+	{
+		UUEDebuggerBPLibrary::CustomPrintString(WorldContextObject, StringWithPrefix, bPrintToScreen, bPrintToLog, TextColor, Duration, CategoryName);
+	}
 
 	if (bPrintToConsole)
 	{
@@ -227,38 +261,95 @@ void UUEDebuggerBPLibrary::PrintStringToConsole(UObject* WorldContextObject, con
 		// APlayerController* MyPC = World->GetGameInstance()->GetFirstLocalPlayerController();
 
 		FString NetMode = World->GetNetMode() == ENetMode::NM_Standalone ? TEXT("") : (World->GetNetMode() == ENetMode::NM_Client ? TEXT("Client: ") : TEXT("Server: "));
+		const FString ConsoleString = NetMode + StringWithPrefix;
 
 		for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
 		{
 			APlayerController* PlayerController = Iterator->Get();
 			if (PlayerController != nullptr)
 			{
-				PlayerController->ClientMessage(NetMode + StringWithPrefix, CategoryName, Duration);
+				// Remote clients may have subscribed to their own categories.
+				UUEDebuggerNetComponent* NetComponent = PlayerController->IsLocalController() ? nullptr : PlayerController->FindComponentByClass<UUEDebuggerNetComponent>();
+				if (NetComponent ? !NetComponent->WantsCategory(CategoryName, bCategoryEnabled) : !bCategoryEnabled)
+				{
+					continue;
+				}
+
+				// Remote clients receive the messages of this frame as one batched RPC.
+				if (UUEDebuggerNetComponent::ShouldBatchClientMessages(PlayerController))
+				{
+					NetComponent = NetComponent ? NetComponent : UUEDebuggerNetComponent::FindOrAdd(PlayerController);
+					if (NetComponent)
+					{
+						NetComponent->QueueClientMessage(ConsoleString, CategoryName, Duration);
+						continue;
+					}
+				}
+
+				PlayerController->ClientMessage(ConsoleString, CategoryName, Duration);
 			}
 		}
 	}
 #endif
 }
 
-void UUEDebuggerBPLibrary::CustomPrintString(UObject* WorldContextObject, const FString& InString, bool bPrintToScreen, bool bPrintToLog, FLinearColor TextColor, float Duration)
+bool UUEDebuggerBPLibrary::IsPrintStringToConsoleCategoryEnabled(const FName& CategoryName)
+{
+#if !NO_LOGGING
+	return FPrintStringToConsoleCategoryFilter::Get().IsCategoryEnabled(CategoryName) || UUEDebuggerNetComponent::HasAnySubscriber(CategoryName);
+#else
+	return false;
+#endif
+}
+
+void UUEDebuggerBPLibrary::CustomPrintString(UObject* WorldContextObject, const FString& InString, bool bPrintToScreen, bool bPrintToLog, FLinearColor TextColor, float Duration, const FName& CategoryName, uint64 ScreenMessageKey)
+{
+	CustomPrintStringView(WorldContextObject, FStringView(InString), bPrintToScreen, bPrintToLog, TextColor, Duration, CategoryName, ScreenMessageKey);
+}
+
+void UUEDebuggerBPLibrary::CustomPrintStringView(UObject* WorldContextObject, FStringView InString, bool bPrintToScreen, bool bPrintToLog, FLinearColor TextColor, float Duration, const FName& CategoryName, uint64 ScreenMessageKey)
 {
 // #if !(UE_BUILD_SHIPPING || NO_LOGGING) // Do not Print in Shipping or NO_LOGGING
 #if !(NO_LOGGING) // Do not Print in NO_LOGGING
 
+	// Not safe out of the game thread, queued and printed at the end of the frame.
+	if (!IsInGameThread())
+	{
+		FUEDebuggerQueuedMessage Message;
+		Message.WorldContextObject = WorldContextObject;
+		Message.Message = FString(InString.Len(), InString.GetData());
+		Message.TextColor = TextColor;
+		Message.Duration = Duration;
+		Message.bPrintToScreen = bPrintToScreen;
+		Message.bPrintToLog = bPrintToLog;
+		Message.CategoryName = CategoryName;
+		Message.ScreenMessageKey = ScreenMessageKey;
+		Message.bCustomPrintString = true;
+		FUEDebuggerMessageQueue::Get().Enqueue(MoveTemp(Message));
+		return;
+	}
+
 	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
-	FString Prefix;
+	const TCHAR* Prefix = TEXT("");
+	TCHAR ClientPrefix[32];
+	int32 PIEInstance = INDEX_NONE;
 	if (World)
 	{
 		if (World->WorldType == EWorldType::PIE)
 		{
+			// GPlayInEditorID is only the instance of World while World ticks, not when the output of the frame is flushed.
+			const FWorldContext* WorldContext = GEngine->GetWorldContextFromWorld(World);
+			PIEInstance = WorldContext ? WorldContext->PIEInstance : GPlayInEditorID;
+
 			switch (World->GetNetMode())
 			{
 			case NM_Client:
-				Prefix = FString::Printf(TEXT("Client%d: "), GPlayInEditorID);
+				FCString::Sprintf(ClientPrefix, TEXT("Client%d: "), PIEInstance);
+				Prefix = ClientPrefix;
 				break;
 			case NM_DedicatedServer:
 			case NM_ListenServer:
-				Prefix = FString::Printf(TEXT("Server: "));
+				Prefix = TEXT("Server: ");
 				break;
 			case NM_Standalone:
 				break;
@@ -266,30 +357,46 @@ void UUEDebuggerBPLibrary::CustomPrintString(UObject* WorldContextObject, const
 		}
 	}
 
-	const FString FinalDisplayString = Prefix + InString;
-	FString FinalLogString = FinalDisplayString;
-
 	static const FBoolConfigValueHelper DisplayPrintStringSource(TEXT("Kismet"), TEXT("bLogPrintStringSource"), GEngineIni);
+	TStringBuilder<256> SourceObjectPrefix;
 	if (DisplayPrintStringSource)
 	{
-		const FString SourceObjectPrefix = FString::Printf(TEXT("[%s] "), *GetNameSafe(WorldContextObject));
-		FinalLogString = SourceObjectPrefix + FinalLogString;
+		SourceObjectPrefix << TEXT("[");
+		if (WorldContextObject)
+		{
+			WorldContextObject->GetFName().AppendString(SourceObjectPrefix);
+		}
+		else
+		{
+			SourceObjectPrefix << TEXT("None");
+		}
+		SourceObjectPrefix << TEXT("] ");
 	}
 
 	if (bPrintToLog)
 	{
-		UE_LOG(LogUEDebuggerPrintStringToConsole, Log, TEXT("%s"), *FinalLogString);
+		if (FUEDebuggerMergedLog::IsEnabled())
+		{
+			FUEDebuggerMergedLog::Get().Add(PIEInstance, Prefix, InString);
+		}
+
+		UE_LOG(LogUEDebuggerPrintStringToConsole, Log, TEXT("%s%s%.*s"), SourceObjectPrefix.ToString(), Prefix, InString.Len(), InString.GetData());
 
 		APlayerController* PC = (WorldContextObject ? UGameplayStatics::GetPlayerController(WorldContextObject, 0) : NULL);
 		ULocalPlayer* LocalPlayer = (PC ? Cast<ULocalPlayer>(PC->Player) : NULL);
 		if (LocalPlayer && LocalPlayer->ViewportClient && LocalPlayer->ViewportClient->ViewportConsole)
 		{
-			LocalPlayer->ViewportClient->ViewportConsole->OutputText(FinalDisplayString);
+			// Only on the game thread, the buffer keeps its capacity from one print to the next.
+			static FString ConsoleString;
+			ConsoleString.Reset();
+			ConsoleString.Append(Prefix);
+			ConsoleString.Append(InString.GetData(), InString.Len());
+			LocalPlayer->ViewportClient->ViewportConsole->OutputText(ConsoleString);
 		}
 	}
 	else
 	{
-		UE_LOG(LogUEDebuggerPrintStringToConsole, Verbose, TEXT("%s"), *FinalLogString);
+		UE_LOG(LogUEDebuggerPrintStringToConsole, Verbose, TEXT("%s%s%.*s"), SourceObjectPrefix.ToString(), Prefix, InString.Len(), InString.GetData());
 	}
 
 	// Also output to the screen, if possible
@@ -301,7 +408,17 @@ void UUEDebuggerBPLibrary::CustomPrintString(UObject* WorldContextObject, const
 			{
 				GConfig->GetFloat(TEXT("Kismet"), TEXT("PrintStringDuration"), Duration, GEngineIni);
 			}
-			GEngine->AddOnScreenDebugMessage((uint64)-1, Duration, TextColor.ToFColor(true), FinalDisplayString);
+
+			if (*Prefix)
+			{
+				TStringBuilder<1024> FinalDisplayString;
+				FinalDisplayString << Prefix << InString;
+				FUEDebuggerScreenMessages::Get().AddMessage(FinalDisplayString.ToView(), CategoryName, ScreenMessageKey, Duration, TextColor.ToFColor(true));
+			}
+			else
+			{
+				FUEDebuggerScreenMessages::Get().AddMessage(InString, CategoryName, ScreenMessageKey, Duration, TextColor.ToFColor(true));
+			}
 		}
 		else
 		{
@@ -349,6 +466,20 @@ void UUEDebuggerBPLibrary::GetAllConsoleCommandGroupNames(UObject* WorldContextO
 	AllConsoleCommandGroupNames = IConsoleCommandGroupManager::Get().GetAllConsoleCommandGroupObjectNames();
 }
 
+void UUEDebuggerBPLibrary::GetConsoleCommandGroupNamesIfChanged(UObject* WorldContextObject, int32& Serial, TArray<FString>& ConsoleCommandGroupNames, bool& bChanged)
+{
+	IConsoleCommandGroupManager& Manager = IConsoleCommandGroupManager::Get();
+
+	// Read before the names, a change in between is seen by the next call.
+	const int32 CurrentSerial = int32(Manager.GetConsoleCommandGroupObjectsSerial());
+	bChanged = CurrentSerial != Serial;
+	if (bChanged)
+	{
+		ConsoleCommandGroupNames = Manager.GetAllConsoleCommandGroupObjectNames();
+		Serial = CurrentSerial;
+	}
+}
+
 void UUEDebuggerBPLibrary::EnableConsoleCommandGroup(UObject* WorldContextObject, APlayerController* Player, const FString& ConsoleCommandGroupName)
 {
 	IConsoleCommandGroupObject* ConsoleCommandGroupObject = IConsoleCommandGroupManager::Get().FindConsoleCommandGroupObject(ConsoleCommandGroupName);
@@ -367,6 +498,14 @@ void UUEDebuggerBPLibrary::DisableConsoleCommandGroup(UObject* WorldContextObjec
 	}
 }
 
+void UUEDebuggerBPLibrary::EnableConsoleCommandGroupFor(UObject* WorldContextObject, APlayerController* Player, const FString& ConsoleCommandGroupName, float Duration, bool bDurationInFrames, bool& Succeed)
+{
+	const int32 NumFrames = bDurationInFrames ? FMath::CeilToInt(Duration) : 0;
+	const float Seconds = bDurationInFrames ? 0.0f : Duration;
+
+	Succeed = (NumFrames > 0 || Seconds > 0.0f) && IConsoleCommandGroupManager::Get().EnableConsoleCommandGroupObjectFor(ConsoleCommandGroupName, WorldContextObject, Player, NumFrames, Seconds);
+}
+
 void UUEDebuggerBPLibrary::GetWorldFromObject(UObject* InObject, UObject*& OutWorldContextObject, UWorld*& OutWorld)
 {
 	if (InObject)
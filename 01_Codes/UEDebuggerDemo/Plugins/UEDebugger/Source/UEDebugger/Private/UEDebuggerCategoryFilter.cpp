@@ -0,0 +1,166 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerCategoryFilter.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<FString> CVarEnableDebugPrintStringToConsole(
+	TEXT("EnableDebug.PrintStringToConsole"),
+	TEXT("0"),
+	TEXT("Toggle PrintStringToConsole.\n")
+	TEXT(" 0: Disable PrintStringToConsole.\n")
+	TEXT(" 1: Enable PrintStringToConsole.\n")
+	TEXT(" CategoryName: Enable PrintStringToConsole for specified CategoryName.\n")
+	TEXT(" CategoryA,Prefix*,-CategoryB: Enable several categories or wildcards, '-' excludes a category or wildcard."),
+	ECVF_Default);
+
+static void OnEnableDebugPrintStringToConsoleChanged(IConsoleVariable* Var)
+{
+	FPrintStringToConsoleCategoryFilter::Get().Rebuild(Var->GetString());
+}
+
+FPrintStringToConsoleCategoryFilter& FPrintStringToConsoleCategoryFilter::Get()
+{
+	static FPrintStringToConsoleCategoryFilter Singleton;
+	return Singleton;
+}
+
+FPrintStringToConsoleCategoryFilter::FPrintStringToConsoleCategoryFilter()
+	: bDisableAll(true)
+	, bEnableAll(false)
+{
+	Rebuild(CVarEnableDebugPrintStringToConsole.GetValueOnAnyThread());
+	CVarEnableDebugPrintStringToConsole.AsVariable()->SetOnChangedCallback(FConsoleVariableDelegate::CreateStatic(&OnEnableDebugPrintStringToConsoleChanged));
+}
+
+bool FPrintStringToConsoleCategoryFilter::IsCategoryEnabled(const FName& CategoryName) const
+{
+	{
+		FReadScopeLock ReadScopeLock(Lock);
+
+		if (bDisableAll)
+		{
+			return false;
+		}
+
+		if (const bool* bEnabled = ResolvedCategories.Find(CategoryName))
+		{
+			return *bEnabled;
+		}
+
+		if (IncludedWildcards.Num() == 0 && ExcludedWildcards.Num() == 0)
+		{
+			return bEnableAll;
+		}
+	}
+
+	// First test of this category against the wildcards, cache the result.
+	FWriteScopeLock WriteScopeLock(Lock);
+	const bool bEnabled = EvaluateWildcards(CategoryName);
+	ResolvedCategories.Add(CategoryName, bEnabled);
+	return bEnabled;
+}
+
+bool FPrintStringToConsoleCategoryFilter::EvaluateWildcards(const FName& CategoryName) const
+{
+	const FString CategoryNameString = CategoryName.ToString();
+
+	for (const FString& Wildcard : ExcludedWildcards)
+	{
+		if (CategoryNameString.MatchesWildcard(Wildcard))
+		{
+			return false;
+		}
+	}
+
+	for (const FString& Wildcard : IncludedWildcards)
+	{
+		if (CategoryNameString.MatchesWildcard(Wildcard))
+		{
+			return true;
+		}
+	}
+
+	return bEnableAll;
+}
+
+void FPrintStringToConsoleCategoryFilter::Rebuild(const FString& Value)
+{
+	static const TCHAR* Delimiters[] = { TEXT(","), TEXT(";"), TEXT(" "), TEXT("\t") };
+
+	TArray<FString> Tokens;
+	Value.ParseIntoArray(Tokens, Delimiters, UE_ARRAY_COUNT(Delimiters), true);
+
+	FWriteScopeLock WriteScopeLock(Lock);
+
+	bEnableAll = false;
+	IncludedWildcards.Reset();
+	ExcludedWildcards.Reset();
+	ResolvedCategories.Reset();
+
+	bool bHasInclusion = false;
+	bool bHasExclusion = false;
+
+	for (FString& Token : Tokens)
+	{
+		Token.TrimStartAndEndInline();
+
+		if (Token.IsEmpty() || Token.Equals(TEXT("0")) || Token.Equals(TEXT("FALSE"), ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+
+		if (Token.Equals(TEXT("1")) || Token.Equals(TEXT("TRUE"), ESearchCase::IgnoreCase) || Token.Equals(TEXT("*")))
+		{
+			bEnableAll = true;
+			continue;
+		}
+
+		const bool bExclusion = Token[0] == TCHAR('-');
+		if (bExclusion)
+		{
+			Token.RightChopInline(1, false);
+			if (Token.IsEmpty())
+			{
+				continue;
+			}
+		}
+
+		bHasInclusion |= !bExclusion;
+		bHasExclusion |= bExclusion;
+
+		if (Token.Contains(TEXT("*")) || Token.Contains(TEXT("?")))
+		{
+			(bExclusion ? ExcludedWildcards : IncludedWildcards).Add(Token);
+		}
+		else if (bExclusion)
+		{
+			// Exclusions always win over inclusions of the same category.
+			ResolvedCategories.Add(FName(*Token), false);
+		}
+		else
+		{
+			ResolvedCategories.FindOrAdd(FName(*Token), true);
+		}
+	}
+
+	// Excluded wildcards also win over the listed categories.
+	if (ExcludedWildcards.Num() > 0)
+	{
+		for (TPair<FName, bool>& Pair : ResolvedCategories)
+		{
+			const FString CategoryNameString = Pair.Key.ToString();
+			for (const FString& Wildcard : ExcludedWildcards)
+			{
+				Pair.Value = Pair.Value && !CategoryNameString.MatchesWildcard(Wildcard);
+			}
+		}
+	}
+
+	// Only exclusions, such as "-CategoryA": every other category is enabled.
+	if (bHasExclusion && !bHasInclusion)
+	{
+		bEnableAll = true;
+	}
+
+	bDisableAll = !bEnableAll && !bHasInclusion;
+}
@@ -4,9 +4,56 @@
 #include "UEDebugger.h"
 #include "UnrealEngine.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Paths.h"
+#include "CoreGlobals.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogConsoleCommandGroupManager, Log, All);
 
+static const TCHAR* ConsoleCommandGroupsConfigSection = TEXT("UEDebugger.ConsoleCommandGroups");
+
+static FAutoConsoleCommand CCmdReloadConsoleCommandGroups(
+	TEXT("UEDebugger.ReloadConsoleCommandGroups"),
+	TEXT("Reads the ConsoleCommandGroups of the section [UEDebugger.ConsoleCommandGroups] of DefaultGame.ini again, and registers the new or changed ones.\n")
+	TEXT("In the editor, this is done when a file of the Config folder of the project is saved."),
+	FConsoleCommandDelegate::CreateLambda([]()
+		{
+			IConsoleCommandGroupManager::Get().ReloadConfigConsoleCommandGroups();
+		}));
+
+static FAutoConsoleCommandWithWorldAndArgs CCmdEnableGroupFor(
+	TEXT("UEDebugger.EnableGroupFor"),
+	TEXT("Arguments: <ConsoleCommandGroupName> <N>f|<N>s\n")
+	TEXT("Enables the group for N frames (e.g. 300f) or N seconds (e.g. 5s, the default unit), then disables it."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (Args.Num() != 2)
+			{
+				UE_LOG(LogConsoleCommandGroupManager, Warning, TEXT("Usage: UEDebugger.EnableGroupFor <ConsoleCommandGroupName> <N>f|<N>s"));
+				return;
+			}
+
+			const bool bFrames = Args[1].EndsWith(TEXT("f"), ESearchCase::IgnoreCase);
+			const bool bSeconds = Args[1].EndsWith(TEXT("s"), ESearchCase::IgnoreCase);
+			const FString Duration = bFrames || bSeconds ? Args[1].LeftChop(1) : Args[1];
+			const int32 NumFrames = bFrames ? FCString::Atoi(*Duration) : 0;
+			const float Seconds = bFrames ? 0.0f : FCString::Atof(*Duration);
+
+			if (NumFrames <= 0 && Seconds <= 0.0f)
+			{
+				UE_LOG(LogConsoleCommandGroupManager, Warning, TEXT("UEDebugger.EnableGroupFor: invalid duration %s"), *Args[1]);
+				return;
+			}
+
+			if (!IConsoleCommandGroupManager::Get().EnableConsoleCommandGroupObjectFor(Args[0], World, nullptr, NumFrames, Seconds))
+			{
+				UE_LOG(LogConsoleCommandGroupManager, Warning, TEXT("UEDebugger.EnableGroupFor: no ConsoleCommandGroup named %s"), *Args[0]);
+				return;
+			}
+
+			UE_LOG(LogConsoleCommandGroupManager, Log, TEXT("UEDebugger.EnableGroupFor: %s enabled for %s"), *Args[0], *Args[1]);
+		}));
+
 IConsoleCommandGroupManager* IConsoleCommandGroupManager::Singleton;
 
 void IConsoleCommandGroupManager::SetupSingleton()
@@ -27,6 +74,58 @@ FConsoleCommandGroupManager::~FConsoleCommandGroupManager()
 
 		delete Var;
 	}
+
+	for (const FRetiredSnapshot& RetiredSnapshot : RetiredSnapshots)
+	{
+		for (IConsoleCommandGroupObject* Object : RetiredSnapshot.ReleasedObjects)
+		{
+			delete Object;
+		}
+		delete RetiredSnapshot.Snapshot;
+	}
+	delete Snapshot.load();
+}
+
+void FConsoleCommandGroupManager::PublishSnapshot()
+{
+	if (DeferPublishSnapshotCount > 0)
+	{
+		return;
+	}
+
+	const FRegistrySnapshot* OldSnapshot = Snapshot.load(std::memory_order_relaxed);
+
+	FRegistrySnapshot* NewSnapshot = new FRegistrySnapshot;
+	NewSnapshot->ConsoleCommandGroupObjects = ConsoleCommandGroupObjects;
+	ConsoleCommandGroupObjects.GenerateKeyArray(NewSnapshot->Names);
+	NewSnapshot->Serial = OldSnapshot->Serial + 1;
+
+	Snapshot.store(NewSnapshot, std::memory_order_release);
+	RetiredSnapshots.Add({ OldSnapshot, GFrameCounter, MoveTemp(PendingReleases) });
+	PendingReleases.Reset();
+}
+
+void FConsoleCommandGroupManager::DeleteRetiredSnapshots()
+{
+	TArray<IConsoleCommandGroupObject*, TInlineAllocator<8>> ObjectsToRelease;
+	{
+		FScopeLock ScopeLock(&ConsoleCommandGroupObjectsSynchronizationObject);
+
+		// A lookup started before the change has returned by the end of the frame which made it.
+		int32 NumDeleted = 0;
+		for (; NumDeleted < RetiredSnapshots.Num() && RetiredSnapshots[NumDeleted].Frame < GFrameCounter; NumDeleted++)
+		{
+			ObjectsToRelease.Append(RetiredSnapshots[NumDeleted].ReleasedObjects);
+			delete RetiredSnapshots[NumDeleted].Snapshot;
+		}
+		RetiredSnapshots.RemoveAt(0, NumDeleted, false);
+	}
+
+	// No snapshot references them anymore. Released without the lock, restoring their console variables can take time.
+	for (IConsoleCommandGroupObject* Object : ObjectsToRelease)
+	{
+		Object->Release();
+	}
 }
 
 IConsoleCommandGroupObject* FConsoleCommandGroupManager::RegisterConsoleCommandGroupObject(const FString& Name, const TArray<FString>& InConsoleCommandsToEnable, const TArray<FString>& InConsoleCommandsToDisable)
@@ -42,10 +141,10 @@ void FConsoleCommandGroupManager::UnregisterConsoleCommandGroupObject(IConsoleCo
 	}
 	FScopeLock ScopeLock(&ConsoleCommandGroupObjectsSynchronizationObject);
 
-	const FString ObjName = FindConsoleCommandGroupObjectName(ConsoleCommandGroupObject);
-	if (!ObjName.IsEmpty())
+	if (const FString* ObjName = ConsoleCommandGroupObjectNames.Find(ConsoleCommandGroupObject))
 	{
-		UnregisterConsoleCommandGroupObject(ObjName);
+		// Copied, removed from the map by the unregistration.
+		UnregisterConsoleCommandGroupObject(FString(*ObjName));
 	}
 }
 
@@ -53,34 +152,243 @@ void FConsoleCommandGroupManager::UnregisterConsoleCommandGroupObject(const FStr
 {
 	FScopeLock ScopeLock(&ConsoleCommandGroupObjectsSynchronizationObject);
 
-	IConsoleCommandGroupObject* Object = FindConsoleCommandGroupObject(Name);
-
-	if (Object)
+	IConsoleCommandGroupObject* Object = nullptr;
+	if (ConsoleCommandGroupObjects.RemoveAndCopyValue(Name, Object))
 	{
-		ConsoleCommandGroupObjects.Remove(Name);
-		Object->Release();
+		ConsoleCommandGroupObjectNames.Remove(Object);
+
+		// A group registered again under Name must not be disabled by the window of the old one. The windows only live on the game thread.
+		if (IsInGameThread())
+		{
+			CancelConsoleCommandGroupObjectWindow(Name);
+		}
+
+		// The current snapshot, and the lookups reading it, still point to the group: it is released with that snapshot, once retired.
+		PendingReleases.Add(Object);
+		PublishSnapshot();
 	}
 }
 
 IConsoleCommandGroupObject* FConsoleCommandGroupManager::FindConsoleCommandGroupObject(const FString& Name) const
 {
-	FScopeLock ScopeLock(&ConsoleCommandGroupObjectsSynchronizationObject);
-	IConsoleCommandGroupObject* ConsoleCommandGroupObject = ConsoleCommandGroupObjects.FindRef(Name);
-	return ConsoleCommandGroupObject;
+	LoadConfigConsoleCommandGroups();
+
+	return GetSnapshot().ConsoleCommandGroupObjects.FindRef(Name);
 }
 
 bool FConsoleCommandGroupManager::IsNameRegistered(const FString& Name) const
 {
+	LoadConfigConsoleCommandGroups();
+
+	return GetSnapshot().ConsoleCommandGroupObjects.Contains(Name);
+}
+
+const TArray<FString>& FConsoleCommandGroupManager::GetAllConsoleCommandGroupObjectNames() const
+{
+	LoadConfigConsoleCommandGroups();
+
+	return GetSnapshot().Names;
+}
+
+uint32 FConsoleCommandGroupManager::GetConsoleCommandGroupObjectsSerial() const
+{
+	LoadConfigConsoleCommandGroups();
+
+	return GetSnapshot().Serial;
+}
+
+bool FConsoleCommandGroupManager::EnableConsoleCommandGroupObjectFor(const FString& Name, UObject* WorldContextObject, APlayerController* Player, int32 NumFrames, float Seconds)
+{
+	check(IsInGameThread());
+
+	IConsoleCommandGroupObject* ConsoleCommandGroupObject = FindConsoleCommandGroupObject(Name);
+	if (!ConsoleCommandGroupObject)
+	{
+		return false;
+	}
+
+	FTimedConsoleCommandGroup* TimedGroup = TimedConsoleCommandGroups.FindByPredicate([&Name](const FTimedConsoleCommandGroup& Timed) { return Timed.Name == Name; });
+	if (!TimedGroup)
+	{
+		TimedGroup = &TimedConsoleCommandGroups.AddDefaulted_GetRef();
+		TimedGroup->Name = Name;
+	}
+
+	TimedGroup->WorldContextObject = WorldContextObject;
+	TimedGroup->Player = Player;
+	TimedGroup->EndFrame = NumFrames > 0 ? GFrameCounter + uint64(NumFrames) : MAX_uint64;
+	TimedGroup->EndSeconds = NumFrames > 0 ? DBL_MAX : FPlatformTime::Seconds() + Seconds;
+
+	ConsoleCommandGroupObject->Enable(WorldContextObject, Player);
+	return true;
+}
+
+void FConsoleCommandGroupManager::Tick()
+{
+	if (RetiredSnapshots.Num() > 0)
+	{
+		DeleteRetiredSnapshots();
+	}
+
+	if (TimedConsoleCommandGroups.Num() == 0)
+	{
+		return;
+	}
+
+	check(IsInGameThread());
+
+	const uint64 FrameCounter = GFrameCounter;
+	const double NowSeconds = FPlatformTime::Seconds();
+
+	for (int32 Index = TimedConsoleCommandGroups.Num() - 1; Index >= 0; Index--)
+	{
+		if (FrameCounter + 1 < TimedConsoleCommandGroups[Index].EndFrame && NowSeconds < TimedConsoleCommandGroups[Index].EndSeconds)
+		{
+			continue;
+		}
+
+		// Removed before Disable(), which cancels the window of the group.
+		const FTimedConsoleCommandGroup TimedGroup = TimedConsoleCommandGroups[Index];
+		TimedConsoleCommandGroups.RemoveAtSwap(Index);
+
+		// The world of the group may have been destroyed, then only the console variables are restored.
+		if (IConsoleCommandGroupObject* ConsoleCommandGroupObject = FindConsoleCommandGroupObject(TimedGroup.Name))
+		{
+			ConsoleCommandGroupObject->Disable(TimedGroup.WorldContextObject.Get(), TimedGroup.Player.Get());
+		}
+	}
+}
+
+void FConsoleCommandGroupManager::CancelConsoleCommandGroupObjectWindow(const FString& Name)
+{
+	check(IsInGameThread());
+
+	if (TimedConsoleCommandGroups.Num() > 0)
+	{
+		TimedConsoleCommandGroups.RemoveAllSwap([&Name](const FTimedConsoleCommandGroup& Timed) { return Timed.Name == Name; });
+	}
+}
+
+void FConsoleCommandGroupManager::LoadConfigConsoleCommandGroups() const
+{
+	if (bConfigConsoleCommandGroupsLoaded.load(std::memory_order_acquire) || !GConfig)
+	{
+		return;
+	}
+
 	FScopeLock ScopeLock(&ConsoleCommandGroupObjectsSynchronizationObject);
-	return ConsoleCommandGroupObjects.Contains(Name);
+	if (bConfigConsoleCommandGroupsLoaded.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+	// Before applying, the lookups of the registration must not load again.
+	bConfigConsoleCommandGroupsLoaded.store(true, std::memory_order_release);
+
+	TArray<FString> Definitions;
+	GConfig->GetArray(ConsoleCommandGroupsConfigSection, TEXT("Group"), Definitions, GGameIni);
+
+	// Lazily loaded by the const lookups.
+	const_cast<FConsoleCommandGroupManager*>(this)->ApplyConfigConsoleCommandGroups(Definitions);
 }
 
-TArray<FString> FConsoleCommandGroupManager::GetAllConsoleCommandGroupObjectNames() const
+void FConsoleCommandGroupManager::ReloadConfigConsoleCommandGroups()
 {
+	check(IsInGameThread());
+
+	// The groups of the old ini are needed to find the differences.
+	LoadConfigConsoleCommandGroups();
+
+	FConfigFile ConfigFile;
+	if (!FConfigCacheIni::LoadExternalIniFile(ConfigFile, TEXT("Game"), *FPaths::EngineConfigDir(), *FPaths::SourceConfigDir(), true, nullptr, true))
+	{
+		UE_LOG(LogConsoleCommandGroupManager, Warning, TEXT("UEDebugger.ReloadConsoleCommandGroups: could not read the Game ini files"));
+		return;
+	}
+
+	TArray<FString> Definitions;
+	ConfigFile.GetArray(ConsoleCommandGroupsConfigSection, TEXT("Group"), Definitions);
+
 	FScopeLock ScopeLock(&ConsoleCommandGroupObjectsSynchronizationObject);
-	TArray<FString> NameArray;
-	ConsoleCommandGroupObjects.GenerateKeyArray(NameArray);
-	return NameArray;
+	ApplyConfigConsoleCommandGroups(Definitions);
+}
+
+void FConsoleCommandGroupManager::ApplyConfigConsoleCommandGroups(const TArray<FString>& Definitions)
+{
+	TMap<FString, FConfigConsoleCommandGroup> NewGroups;
+	for (const FString& Definition : Definitions)
+	{
+		FString Name;
+		if (!FParse::Value(*Definition, TEXT("Name="), Name) || Name.IsEmpty())
+		{
+			UE_LOG(LogConsoleCommandGroupManager, Warning, TEXT("[%s] Group without Name: %s"), ConsoleCommandGroupsConfigSection, *Definition);
+			continue;
+		}
+
+		FString EnableString;
+		FString DisableString;
+		FParse::Value(*Definition, TEXT("Enable="), EnableString, false);
+		FParse::Value(*Definition, TEXT("Disable="), DisableString, false);
+
+		FConfigConsoleCommandGroup& Group = NewGroups.Add(Name);
+		EnableString.ParseIntoArray(Group.ConsoleCommandsToEnable, TEXT(";"), true);
+		DisableString.ParseIntoArray(Group.ConsoleCommandsToDisable, TEXT(";"), true);
+		for (FString& Command : Group.ConsoleCommandsToEnable)
+		{
+			Command.TrimStartAndEndInline();
+		}
+		for (FString& Command : Group.ConsoleCommandsToDisable)
+		{
+			Command.TrimStartAndEndInline();
+		}
+	}
+
+	// One snapshot for the whole batch.
+	DeferPublishSnapshotCount++;
+
+	int32 NumRemoved = 0;
+	for (const TPair<FString, FConfigConsoleCommandGroup>& OldGroup : ConfigConsoleCommandGroups)
+	{
+		const FConfigConsoleCommandGroup* NewGroup = NewGroups.Find(OldGroup.Key);
+		if (!NewGroup || !(*NewGroup == OldGroup.Value))
+		{
+			UnregisterConsoleCommandGroupObject(OldGroup.Key);
+			NumRemoved++;
+		}
+	}
+
+	int32 NumAdded = 0;
+	TMap<FString, FConfigConsoleCommandGroup> AppliedGroups;
+	for (TPair<FString, FConfigConsoleCommandGroup>& NewGroup : NewGroups)
+	{
+		const FConfigConsoleCommandGroup* OldGroup = ConfigConsoleCommandGroups.Find(NewGroup.Key);
+		const bool bRegistered = ConsoleCommandGroupObjects.Contains(NewGroup.Key);
+		if (!(OldGroup && *OldGroup == NewGroup.Value && bRegistered))
+		{
+			// The groups of C++ and Blueprint win.
+			if (bRegistered)
+			{
+				UE_LOG(LogConsoleCommandGroupManager, Warning, TEXT("[%s] ConsoleCommandGroup %s is already registered, ignored."), ConsoleCommandGroupsConfigSection, *NewGroup.Key);
+				continue;
+			}
+
+			RegisterConsoleCommandGroupObject(NewGroup.Key, NewGroup.Value.ConsoleCommandsToEnable, NewGroup.Value.ConsoleCommandsToDisable);
+			NumAdded++;
+		}
+		AppliedGroups.Add(NewGroup.Key, MoveTemp(NewGroup.Value));
+	}
+
+	ConfigConsoleCommandGroups = MoveTemp(AppliedGroups);
+
+	DeferPublishSnapshotCount--;
+	if (NumAdded > 0 || NumRemoved > 0)
+	{
+		PublishSnapshot();
+	}
+
+	if (NumAdded > 0 || NumRemoved > 0)
+	{
+		UE_LOG(LogConsoleCommandGroupManager, Log, TEXT("[%s] %d ConsoleCommandGroups, %d registered, %d unregistered."), ConsoleCommandGroupsConfigSection, ConfigConsoleCommandGroups.Num(), NumAdded, NumRemoved);
+	}
 }
 
 IConsoleCommandGroupObject* FConsoleCommandGroupManager::AddConsoleCommandGroupObject(const FString& Name, IConsoleCommandGroupObject* Obj)
@@ -99,6 +407,8 @@ IConsoleCommandGroupObject* FConsoleCommandGroupManager::AddConsoleCommandGroupO
 	else
 	{
 		ConsoleCommandGroupObjects.Add(Name, Obj);
+		ConsoleCommandGroupObjectNames.Add(Obj, Name);
+		PublishSnapshot();
 		return Obj;
 	}
 }
@@ -108,23 +418,128 @@ FString FConsoleCommandGroupManager::FindConsoleCommandGroupObjectName(const ICo
 	check(Obj);
 
 	FScopeLock ScopeLock(&ConsoleCommandGroupObjectsSynchronizationObject);
-	for (TMap<FString, IConsoleCommandGroupObject*>::TConstIterator PairIt(ConsoleCommandGroupObjects); PairIt; ++PairIt)
+	const FString* Name = ConsoleCommandGroupObjectNames.Find(Obj);
+	return Name ? *Name : FString();
+}
+
+/**
+ * Values of the console variables before the console command groups which set them were enabled. Game thread only.
+ * A variable set by several enabled groups has the value of the last enabled one, the value of the previous group when it is disabled,
+ * and its original value when the last of them is disabled.
+ */
+class FConsoleVariableSnapshots
+{
+public:
+
+	static FConsoleVariableSnapshots& Get()
 	{
-		IConsoleCommandGroupObject* Var = PairIt.Value();
+		static FConsoleVariableSnapshots Singleton;
+		return Singleton;
+	}
+
+	void Acquire(const IConsoleCommandGroupObject* Group, const FString& VariableName, IConsoleVariable* Variable, const FString& Value)
+	{
+		FSnapshot& Snapshot = Snapshots.FindOrAdd(VariableName);
+		if (Snapshot.Overrides.Num() == 0)
+		{
+			Snapshot.bIsInt = Variable->IsVariableInt();
+			Snapshot.bIsFloat = Variable->IsVariableFloat();
+			Snapshot.IntValue = Snapshot.bIsInt ? Variable->GetInt() : 0;
+			Snapshot.FloatValue = Snapshot.bIsFloat ? Variable->GetFloat() : 0.0f;
+			Snapshot.StringValue = Snapshot.bIsInt || Snapshot.bIsFloat ? FString() : Variable->GetString();
+			Snapshot.SetBy = Variable->GetFlags() & ECVF_SetByMask;
+		}
+
+		// A group enabled again moves on top.
+		Snapshot.Overrides.RemoveAll([Group](const FOverride& Override) { return Override.Group == Group; });
+		Snapshot.Overrides.Add(FOverride{ Group, Value });
+
+		Variable->Set(*Value, ECVF_SetByConsole);
+	}
+
+	/** @return false if Group did not set the variable. */
+	bool Release(const IConsoleCommandGroupObject* Group, const FString& VariableName)
+	{
+		FSnapshot* Snapshot = Snapshots.Find(VariableName);
+		const int32 OverrideIndex = Snapshot ? Snapshot->Overrides.IndexOfByPredicate([Group](const FOverride& Override) { return Override.Group == Group; }) : INDEX_NONE;
+		if (OverrideIndex == INDEX_NONE)
+		{
+			return false;
+		}
 
-		if (Var == Obj)
+		const bool bWasOnTop = OverrideIndex == Snapshot->Overrides.Num() - 1;
+		Snapshot->Overrides.RemoveAt(OverrideIndex);
+
+		// Unregistered since the group set it, there is nothing left to restore.
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(*VariableName, false);
+		if (!Variable)
 		{
-			const FString& Name = PairIt.Key();
+			if (Snapshot->Overrides.Num() == 0)
+			{
+				Snapshots.Remove(VariableName);
+			}
+			return true;
+		}
 
-			return Name;
+		// Restored by the console priority, a lower one could not override the value set by the group,
+		// then the priority goes back to what it was, so the ini files and the scalability settings can set the variable again.
+		if (Snapshot->Overrides.Num() == 0)
+		{
+			if (Snapshot->bIsInt)
+			{
+				Variable->Set(Snapshot->IntValue, ECVF_SetByConsole);
+			}
+			else if (Snapshot->bIsFloat)
+			{
+				Variable->Set(Snapshot->FloatValue, ECVF_SetByConsole);
+			}
+			else
+			{
+				Variable->Set(*Snapshot->StringValue, ECVF_SetByConsole);
+			}
+			Variable->SetFlags(EConsoleVariableFlags((Variable->GetFlags() & ~ECVF_SetByMask) | Snapshot->SetBy));
+			Snapshots.Remove(VariableName);
+		}
+		else if (bWasOnTop)
+		{
+			Variable->Set(*Snapshot->Overrides.Last().Value, ECVF_SetByConsole);
 		}
+		return true;
 	}
 
-	return FString();
-}
+private:
+
+	struct FOverride
+	{
+		const IConsoleCommandGroupObject* Group;
+		FString Value;
+	};
+
+	struct FSnapshot
+	{
+		/** Exact value of the variable before the first group set it, the text of a float is not. */
+		bool bIsInt = false;
+		bool bIsFloat = false;
+		int32 IntValue = 0;
+		float FloatValue = 0.0f;
+		FString StringValue;
+
+		/** ECVF_SetBy* priority of the variable before the first group set it by the console. */
+		uint32 SetBy = 0;
+
+		/** The enabled groups which set the variable, the last one is applied. */
+		TArray<FOverride, TInlineAllocator<2>> Overrides;
+	};
+
+	/** [Variable name] = Snapshot, only for the variables set by an enabled group. Keyed by name, the variable can be unregistered meanwhile. */
+	TMap<FString, FSnapshot> Snapshots;
+};
 
 void FConsoleCommandGroupObject::Release()
 {
+	// An enabled group does not leave its values behind.
+	RestoreSnapshot();
+
 	delete this;
 }
 
@@ -140,24 +555,129 @@ void FConsoleCommandGroupObject::SetHelp(const FString Value)
 
 void FConsoleCommandGroupObject::Enable(UObject* WorldContextObject, APlayerController* Player)
 {
+	ResolveCommands();
+
 	// First, try routing through the primary player
 	APlayerController* TargetPC = Player ? Player : UGameplayStatics::GetPlayerController(WorldContextObject, 0);
-	if (TargetPC)
+
+	for (const FConsoleCommandGroupEntry& Entry : EntriesToEnable)
 	{
-		for (auto& ConsoleCommand : ConsoleCommandsToEnable)
+		if (IConsoleVariable* Variable = Entry.FindVariable())
 		{
-			TargetPC->ConsoleCommand(ConsoleCommand, true);
+			// As the console would set it, without parsing the command again, and restored by Disable().
+			FConsoleVariableSnapshots::Get().Acquire(this, Entry.VariableName, Variable, Entry.Value);
+			SnapshotVariables.AddUnique(Entry.VariableName);
+		}
+		else if (TargetPC)
+		{
+			TargetPC->ConsoleCommand(Entry.Command, true);
 		}
 	}
 }
 
 void FConsoleCommandGroupObject::Disable(UObject* WorldContextObject, APlayerController* Player)
+{
+	// Disabled by hand before the end of its window: the window must not disable it again.
+	IConsoleCommandGroupManager::Get().CancelConsoleCommandGroupObjectWindow(Name);
+
+	ResolveCommands();
+
+	TArray<FString, TInlineAllocator<64>> RestoredVariables(SnapshotVariables);
+	RestoreSnapshot();
+
+	// First, try routing through the primary player
+	APlayerController* TargetPC = Player ? Player : UGameplayStatics::GetPlayerController(WorldContextObject, 0);
+
+	// The variables restored to their previous values are not set again by ConsoleCommandsToDisable.
+	for (const FConsoleCommandGroupEntry& Entry : EntriesToDisable)
+	{
+		if (IConsoleVariable* Variable = Entry.FindVariable())
+		{
+			if (!RestoredVariables.Contains(Entry.VariableName))
+			{
+				Variable->Set(*Entry.Value, ECVF_SetByConsole);
+			}
+		}
+		else if (TargetPC)
+		{
+			TargetPC->ConsoleCommand(Entry.Command, true);
+		}
+	}
+}
+
+void FConsoleCommandGroupObject::RestoreSnapshot()
+{
+	// Also called by the destructors of the static TAutoConsoleCommandGroup objects, after FConsoleVariableSnapshots and the console variables may be gone.
+	if (IsEngineExitRequested())
+	{
+		SnapshotVariables.Reset();
+		return;
+	}
+
+	for (const FString& VariableName : SnapshotVariables)
+	{
+		FConsoleVariableSnapshots::Get().Release(this, VariableName);
+	}
+	SnapshotVariables.Reset();
+}
+
+void FConsoleCommandGroupObject::ResolveCommands()
+{
+	if (!bCommandsResolved)
+	{
+		ResolveCommands(ConsoleCommandsToEnable, EntriesToEnable);
+		ResolveCommands(ConsoleCommandsToDisable, EntriesToDisable);
+		bCommandsResolved = true;
+	}
+}
+
+void FConsoleCommandGroupObject::ResolveCommands(const TArray<FString>& Commands, TArray<FConsoleCommandGroupEntry>& OutEntries)
+{
+	OutEntries.Reset(Commands.Num());
+
+	for (const FString& Command : Commands)
+	{
+		FConsoleCommandGroupEntry& Entry = OutEntries.AddDefaulted_GetRef();
+		Entry.Command = Command;
+
+		FString VariableName;
+		FString Value;
+		if (!Command.TrimStartAndEnd().Split(TEXT(" "), &VariableName, &Value))
+		{
+			continue;
+		}
+		Value.TrimStartAndEndInline();
+
+		// Queries ("r.Foo" or "r.Foo ?"), several commands and quoted values are left to the console.
+		if (Value.IsEmpty() || Value == TEXT("?") || Value.Contains(TEXT("|")) || Value.Contains(TEXT("\"")))
+		{
+			continue;
+		}
+
+		Entry.VariableName = MoveTemp(VariableName);
+		Entry.Value = MoveTemp(Value);
+	}
+}
+
+IConsoleVariable* FConsoleCommandGroupEntry::FindVariable() const
+{
+	if (VariableName.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	// Not tracked as a frequent call, a group toggled each frame would be reported as a hot lookup.
+	IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(*VariableName, false);
+	return Variable && !Variable->TestFlags(ECVF_ReadOnly) ? Variable : nullptr;
+}
+
+void FConsoleCommandGroupObject::ExecuteConsoleCommands(UObject* WorldContextObject, APlayerController* Player, const TArray<FString>& Commands)
 {
 	// First, try routing through the primary player
 	APlayerController* TargetPC = Player ? Player : UGameplayStatics::GetPlayerController(WorldContextObject, 0);
 	if (TargetPC)
 	{
-		for (auto& ConsoleCommand : ConsoleCommandsToDisable)
+		for (auto& ConsoleCommand : Commands)
 		{
 			TargetPC->ConsoleCommand(ConsoleCommand, true);
 		}
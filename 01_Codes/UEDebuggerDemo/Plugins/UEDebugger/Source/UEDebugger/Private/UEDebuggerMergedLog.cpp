@@ -0,0 +1,237 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerMergedLog.h"
+#include "UEDebuggerBPLibrary.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogUEDebuggerMergedLog, Log, All);
+
+static TAutoConsoleVariable<int32> CVarMergedLog(
+	TEXT("UEDebugger.MergedLog"),
+	0,
+	TEXT("0: off. 1: the lines of \"CustomPrintString\" of all PIE instances are merged in timestamp order, see \"UEDebugger.MergedLog.Show\" and \"UEDebugger.MergedLog.Export\".\n")
+	TEXT("2: the merged lines are also written to LogUEDebuggerMergedLog at the end of every frame."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMergedLogSize(
+	TEXT("UEDebugger.MergedLog.Size"),
+	8192,
+	TEXT("Number of recent merged lines kept by \"UEDebugger.MergedLog\"."),
+	ECVF_Default);
+
+static FAutoConsoleCommand CCmdMergedLogShow(
+	TEXT("UEDebugger.MergedLog.Show"),
+	TEXT("Arguments: [N]\n")
+	TEXT("Writes the N most recent lines of \"UEDebugger.MergedLog\" to the log, all by default."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			FUEDebuggerMergedLog::Get().Show(Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 0);
+		}));
+
+static FAutoConsoleCommand CCmdMergedLogExport(
+	TEXT("UEDebugger.MergedLog.Export"),
+	TEXT("Arguments: <Filename> / Reset\n")
+	TEXT("Writes the lines of \"UEDebugger.MergedLog\" to Filename. Reset: clear the lines."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() != 1)
+			{
+				UE_LOG(LogUEDebuggerMergedLog, Warning, TEXT("Usage: UEDebugger.MergedLog.Export <Filename> / Reset"));
+				return;
+			}
+
+			if (Args[0].Equals(TEXT("Reset"), ESearchCase::IgnoreCase))
+			{
+				FUEDebuggerMergedLog::Get().Reset();
+				UE_LOG(LogUEDebuggerMergedLog, Log, TEXT("UEDebugger.MergedLog: lines cleared"));
+				return;
+			}
+
+			if (!FUEDebuggerMergedLog::Get().Export(Args[0]))
+			{
+				UE_LOG(LogUEDebuggerMergedLog, Warning, TEXT("UEDebugger.MergedLog.Export: could not write %s"), *Args[0]);
+			}
+		}));
+
+FUEDebuggerMergedLog& FUEDebuggerMergedLog::Get()
+{
+	static FUEDebuggerMergedLog Singleton;
+	return Singleton;
+}
+
+bool FUEDebuggerMergedLog::IsEnabled()
+{
+	return CVarMergedLog.GetValueOnAnyThread() != 0;
+}
+
+void FUEDebuggerMergedLog::Add(int32 PIEInstance, FStringView Prefix, FStringView Text)
+{
+	const int32 ChannelIndex = FMath::Clamp(PIEInstance + 1, 0, MaxChannels - 1);
+	FChannel& Channel = Channels[ChannelIndex];
+
+	FString Line;
+	Line.Reserve(Prefix.Len() + Text.Len());
+	Line.AppendChars(Prefix.GetData(), Prefix.Len());
+	Line.AppendChars(Text.GetData(), Text.Len());
+
+	{
+		FScopeLock ScopeLock(&Channel.CriticalSection);
+
+		// Stamped under the lock of the channel, so the lines of a channel are in timestamp order.
+		FRecord& Record = Channel.Pending.AddDefaulted_GetRef();
+		Record.Cycles = FPlatformTime::Cycles64();
+		Record.FrameCounter = GFrameCounter;
+		Record.Text = MoveTemp(Line);
+
+		uint64 ExpectedStartCycles = 0;
+		StartCycles.compare_exchange_strong(ExpectedStartCycles, Record.Cycles, std::memory_order_relaxed);
+	}
+
+	PendingChannelMask.fetch_or(uint64(1) << ChannelIndex, std::memory_order_release);
+}
+
+void FUEDebuggerMergedLog::Merge()
+{
+	check(IsInGameThread());
+
+	uint64 ChannelMask = PendingChannelMask.exchange(0, std::memory_order_acquire);
+	if (ChannelMask == 0)
+	{
+		return;
+	}
+
+	const bool bWriteToLog = CVarMergedLog.GetValueOnGameThread() >= 2;
+
+	// One cursor per active channel, in a min-heap by timestamp.
+	auto CursorPredicate = [this](const FCursor& A, const FCursor& B)
+	{
+		const uint64 CyclesA = Channels[A.ChannelIndex].Merging[A.RecordIndex].Cycles;
+		const uint64 CyclesB = Channels[B.ChannelIndex].Merging[B.RecordIndex].Cycles;
+		return CyclesA != CyclesB ? CyclesA < CyclesB : A.ChannelIndex < B.ChannelIndex;
+	};
+
+	TArray<FCursor, TInlineAllocator<MaxChannels>> Heap;
+	while (ChannelMask != 0)
+	{
+		const int32 ChannelIndex = int32(FMath::CountTrailingZeros64(ChannelMask));
+		ChannelMask &= ChannelMask - 1;
+
+		FChannel& Channel = Channels[ChannelIndex];
+		{
+			FScopeLock ScopeLock(&Channel.CriticalSection);
+			Swap(Channel.Pending, Channel.Merging);
+		}
+
+		if (Channel.Merging.Num() > 0)
+		{
+			Heap.HeapPush(FCursor{ ChannelIndex, 0 }, CursorPredicate);
+		}
+	}
+
+	while (Heap.Num() > 0)
+	{
+		FCursor Cursor;
+		Heap.HeapPop(Cursor, CursorPredicate, false);
+
+		TArray<FRecord>& Merging = Channels[Cursor.ChannelIndex].Merging;
+		AddMergedRecord(MoveTemp(Merging[Cursor.RecordIndex]), bWriteToLog);
+
+		if (++Cursor.RecordIndex < Merging.Num())
+		{
+			Heap.HeapPush(Cursor, CursorPredicate);
+		}
+	}
+
+	// Keep the memory of the channels for the next frames.
+	for (FChannel& Channel : Channels)
+	{
+		Channel.Merging.Reset();
+	}
+}
+
+void FUEDebuggerMergedLog::AddMergedRecord(FRecord&& Record, bool bWriteToLog)
+{
+	const int32 Size = FMath::Max(1, CVarMergedLogSize.GetValueOnGameThread());
+	if (MergedRecords.Num() != Size)
+	{
+		MergedRecords.Reset();
+		MergedRecords.SetNum(Size);
+		NextMergedRecord = 0;
+		NumMergedRecords = 0;
+	}
+
+	if (bWriteToLog)
+	{
+		FString Line;
+		FormatRecord(Record, Line);
+		UE_LOG(LogUEDebuggerMergedLog, Log, TEXT("%s"), *Line);
+	}
+
+	MergedRecords[NextMergedRecord] = MoveTemp(Record);
+	NextMergedRecord = (NextMergedRecord + 1) % Size;
+	NumMergedRecords++;
+}
+
+void FUEDebuggerMergedLog::FormatRecord(const FRecord& Record, FString& OutLine) const
+{
+	const double Milliseconds = FPlatformTime::ToMilliseconds64(Record.Cycles - StartCycles.load(std::memory_order_relaxed));
+	OutLine = FString::Printf(TEXT("[%12.3fms][%llu] %s"), Milliseconds, Record.FrameCounter, *Record.Text);
+}
+
+void FUEDebuggerMergedLog::Show(int32 NumLines)
+{
+	check(IsInGameThread());
+
+	// Also show the lines of the current frame.
+	Merge();
+
+	const int32 NumAvailable = int32(FMath::Min<int64>(NumMergedRecords, MergedRecords.Num()));
+	const int32 NumToShow = NumLines > 0 ? FMath::Min(NumLines, NumAvailable) : NumAvailable;
+
+	UE_LOG(LogUEDebuggerMergedLog, Log, TEXT("=================== UEDebugger MergedLog: %d of %lld lines ==================="), NumToShow, NumMergedRecords);
+
+	FString Line;
+	for (int32 Age = NumToShow; Age > 0; Age--)
+	{
+		FormatRecord(MergedRecords[(NextMergedRecord - Age + MergedRecords.Num()) % MergedRecords.Num()], Line);
+		UE_LOG(LogUEDebuggerMergedLog, Log, TEXT("%s"), *Line);
+	}
+}
+
+bool FUEDebuggerMergedLog::Export(const FString& Filename)
+{
+	check(IsInGameThread());
+
+	Merge();
+
+	const int32 NumAvailable = int32(FMath::Min<int64>(NumMergedRecords, MergedRecords.Num()));
+
+	FString FileContent;
+	FString Line;
+	for (int32 Age = NumAvailable; Age > 0; Age--)
+	{
+		FormatRecord(MergedRecords[(NextMergedRecord - Age + MergedRecords.Num()) % MergedRecords.Num()], Line);
+		FileContent += Line;
+		FileContent += LINE_TERMINATOR;
+	}
+
+	const bool bSaved = FFileHelper::SaveStringToFile(FileContent, *Filename);
+	if (bSaved)
+	{
+		UE_LOG(LogUEDebuggerMergedLog, Log, TEXT("UEDebugger.MergedLog: %d lines written to %s"), NumAvailable, *Filename);
+	}
+	return bSaved;
+}
+
+void FUEDebuggerMergedLog::Reset()
+{
+	check(IsInGameThread());
+
+	Merge();
+
+	MergedRecords.Reset();
+	NextMergedRecord = 0;
+	NumMergedRecords = 0;
+	StartCycles.store(0, std::memory_order_relaxed);
+}
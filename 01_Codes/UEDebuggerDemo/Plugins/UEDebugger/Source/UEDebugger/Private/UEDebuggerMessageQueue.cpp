@@ -0,0 +1,143 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerMessageQueue.h"
+#include "UEDebuggerBPLibrary.h"
+#include "Misc/ScopeLock.h"
+
+static_assert((FUEDebuggerMessageQueue::StagingBufferCapacity & (FUEDebuggerMessageQueue::StagingBufferCapacity - 1)) == 0, "StagingBufferCapacity must be a power of two.");
+
+FUEDebuggerMessageQueue& FUEDebuggerMessageQueue::Get()
+{
+	static FUEDebuggerMessageQueue Singleton;
+	return Singleton;
+}
+
+FUEDebuggerMessageQueue::FUEDebuggerMessageQueue()
+	: OverflowCount(0)
+	, ReportedOverflowCount(0)
+{
+}
+
+FUEDebuggerMessageQueue::~FUEDebuggerMessageQueue()
+{
+	for (FStagingBuffer* StagingBuffer : StagingBuffers)
+	{
+		delete StagingBuffer;
+	}
+	StagingBuffers.Empty();
+
+	for (FStagingBuffer* StagingBuffer : FreeStagingBuffers)
+	{
+		delete StagingBuffer;
+	}
+	FreeStagingBuffers.Empty();
+}
+
+FUEDebuggerMessageQueue::FStagingBufferOwner::~FStagingBufferOwner()
+{
+	if (StagingBuffer)
+	{
+		// Released after the last push, the game thread drains the buffer before it recycles it.
+		StagingBuffer->bThreadExited.store(true, std::memory_order_release);
+	}
+}
+
+FUEDebuggerMessageQueue::FStagingBuffer& FUEDebuggerMessageQueue::GetStagingBufferOfCurrentThread()
+{
+	static thread_local FStagingBufferOwner Owner;
+	if (!Owner.StagingBuffer)
+	{
+		FScopeLock ScopeLock(&StagingBuffersCriticalSection);
+
+		if (FreeStagingBuffers.Num() > 0)
+		{
+			Owner.StagingBuffer = FreeStagingBuffers.Pop(false);
+			Owner.StagingBuffer->bThreadExited.store(false, std::memory_order_relaxed);
+		}
+		else
+		{
+			Owner.StagingBuffer = new FStagingBuffer();
+		}
+		StagingBuffers.Add(Owner.StagingBuffer);
+	}
+	return *Owner.StagingBuffer;
+}
+
+bool FUEDebuggerMessageQueue::Enqueue(FUEDebuggerQueuedMessage&& Message)
+{
+	FStagingBuffer& StagingBuffer = GetStagingBufferOfCurrentThread();
+
+	const uint32 Head = StagingBuffer.Head.load(std::memory_order_relaxed);
+	const uint32 Tail = StagingBuffer.Tail.load(std::memory_order_acquire);
+	if (Head - Tail >= StagingBufferCapacity)
+	{
+		OverflowCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	StagingBuffer.Slots[Head & (StagingBufferCapacity - 1)] = MoveTemp(Message);
+	StagingBuffer.Head.store(Head + 1, std::memory_order_release);
+	return true;
+}
+
+void FUEDebuggerMessageQueue::Drain()
+{
+	check(IsInGameThread());
+
+	// Only the game thread removes buffers from StagingBuffers, the copied pointers stay valid without the lock.
+	TArray<FStagingBuffer*, TInlineAllocator<64>> StagingBuffersToDrain;
+	{
+		FScopeLock ScopeLock(&StagingBuffersCriticalSection);
+		StagingBuffersToDrain.Append(StagingBuffers);
+	}
+
+	TArray<FStagingBuffer*, TInlineAllocator<8>> EmptiedStagingBuffers;
+	for (FStagingBuffer* StagingBuffer : StagingBuffersToDrain)
+	{
+		// Read before Head: once the thread exited, all its messages are visible.
+		const bool bThreadExited = StagingBuffer->bThreadExited.load(std::memory_order_acquire);
+
+		uint32 Tail = StagingBuffer->Tail.load(std::memory_order_relaxed);
+		const uint32 Head = StagingBuffer->Head.load(std::memory_order_acquire);
+
+		while (Tail != Head)
+		{
+			// Move the message out first, so the slot is released before the sinks run.
+			FUEDebuggerQueuedMessage Message = MoveTemp(StagingBuffer->Slots[Tail & (StagingBufferCapacity - 1)]);
+			++Tail;
+			StagingBuffer->Tail.store(Tail, std::memory_order_release);
+
+			UObject* WorldContextObject = Message.WorldContextObject.Get();
+			if (Message.bCustomPrintString)
+			{
+				UUEDebuggerBPLibrary::CustomPrintString(WorldContextObject, Message.Message, Message.bPrintToScreen, Message.bPrintToLog, Message.TextColor, Message.Duration, Message.CategoryName, Message.ScreenMessageKey);
+			}
+			else
+			{
+				UUEDebuggerBPLibrary::PrintStringToConsole(WorldContextObject, Message.Message, Message.bPrintToConsole, Message.bPrintToScreen, Message.bPrintToLog, Message.TextColor, Message.Duration, Message.CategoryName);
+			}
+		}
+
+		if (bThreadExited)
+		{
+			EmptiedStagingBuffers.Add(StagingBuffer);
+		}
+	}
+
+	if (EmptiedStagingBuffers.Num() > 0)
+	{
+		FScopeLock ScopeLock(&StagingBuffersCriticalSection);
+		for (FStagingBuffer* StagingBuffer : EmptiedStagingBuffers)
+		{
+			StagingBuffers.RemoveSingleSwap(StagingBuffer, false);
+			FreeStagingBuffers.Add(StagingBuffer);
+		}
+	}
+
+	const uint64 CurrentOverflowCount = GetOverflowCount();
+	if (CurrentOverflowCount != ReportedOverflowCount)
+	{
+		UE_LOG(LogUEDebuggerPrintStringToConsole, Warning, TEXT("%llu messages printed from worker threads were dropped, the staging buffers are full (%llu in total)."), CurrentOverflowCount - ReportedOverflowCount, CurrentOverflowCount);
+		ReportedOverflowCount = CurrentOverflowCount;
+	}
+}
@@ -0,0 +1,551 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerNetComponent.h"
+#include "UEDebuggerBPLibrary.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/ScopeRWLock.h"
+
+static TAutoConsoleVariable<int32> CVarClientMessageBatch(
+	TEXT("UEDebugger.ClientMessage.Batch"),
+	1,
+	TEXT("0: PrintStringToConsole sends one reliable ClientMessage per message and player.\n")
+	TEXT("1: PrintStringToConsole sends the messages of a frame as one batch per player."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarClientMessageUnreliable(
+	TEXT("UEDebugger.ClientMessage.Unreliable"),
+	0,
+	TEXT("0: Batches of PrintStringToConsole are reliable.\n")
+	TEXT("1: Batches of PrintStringToConsole are unreliable, lost batches are counted by the client."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarClientMessageMaxPendingMessages(
+	TEXT("UEDebugger.ClientMessage.MaxPendingMessages"),
+	256,
+	TEXT("Maximum number of PrintStringToConsole messages batched per player and frame, the oldest are dropped."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarClientMessageCompressionThreshold(
+	TEXT("UEDebugger.ClientMessage.CompressionThreshold"),
+	512,
+	TEXT("Batches of PrintStringToConsole larger than this number of bytes are compressed."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarClientMessageMaxBatchBytes(
+	TEXT("UEDebugger.ClientMessage.MaxBatchBytes"),
+	32768,
+	TEXT("Maximum size in bytes of a batch of PrintStringToConsole messages before compression, larger frames are sent as several batches.\n")
+	TEXT("Keeps each RPC under the bunch size limit of the net driver, longer messages are truncated."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorld CCmdClientMessageStats(
+	TEXT("UEDebugger.ClientMessageStats"),
+	TEXT("Prints the counters of the batched PrintStringToConsole messages of every player."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (!World)
+			{
+				return;
+			}
+
+			for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+			{
+				APlayerController* PlayerController = Iterator->Get();
+				UUEDebuggerNetComponent* Component = PlayerController ? PlayerController->FindComponentByClass<UUEDebuggerNetComponent>() : nullptr;
+				if (Component)
+				{
+					UE_LOG(LogUEDebuggerPrintStringToConsole, Log, TEXT("%s: Messages = %lld | Dropped = %lld | Batches = %lld | Bytes = %lld | BatchesLost = %lld"),
+						*PlayerController->GetName(), Component->MessagesSent, Component->MessagesDropped, Component->BatchesSent, Component->BytesSent, Component->BatchesLost);
+				}
+			}
+		}));
+
+/** Components with pending messages, flushed at the end of the frame. */
+static TArray<TWeakObjectPtr<UUEDebuggerNetComponent>> GComponentsWithPendingMessages;
+
+static FAutoConsoleCommandWithWorldAndArgs CCmdSubscribe(
+	TEXT("UEDebugger.Subscribe"),
+	TEXT("Arguments: CategoryA CategoryB ...\n")
+	TEXT("Client only. Receive PrintStringToConsole messages of the specified categories from the server, \"*\" for all categories.\n")
+	TEXT("Without argument, receive the categories of the server's EnableDebug.PrintStringToConsole."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			TArray<FName> Categories;
+			for (const FString& Arg : Args)
+			{
+				Categories.AddUnique(FName(*Arg));
+			}
+			UUEDebuggerNetComponent::SetLocalSubscribedCategories(World, Categories);
+		}));
+
+/**
+ * Categories subscribed by the clients, one bit per connection.
+ */
+class FPrintStringToConsoleSubscriptions
+{
+public:
+
+	static FPrintStringToConsoleSubscriptions& Get()
+	{
+		static FPrintStringToConsoleSubscriptions Singleton;
+		return Singleton;
+	}
+
+	int32 AllocateSlot()
+	{
+		FWriteScopeLock WriteScopeLock(Lock);
+		return FreeSlots.Num() > 0 ? FreeSlots.Pop(false) : NumSlots++;
+	}
+
+	void ReleaseSlot(int32 Slot)
+	{
+		SetCategories(Slot, TArray<FName>());
+
+		FWriteScopeLock WriteScopeLock(Lock);
+		FreeSlots.Add(Slot);
+	}
+
+	void SetCategories(int32 Slot, const TArray<FName>& Categories)
+	{
+		FWriteScopeLock WriteScopeLock(Lock);
+
+		SetBit(AllCategoriesSubscribers, Slot, false);
+		for (auto It = CategorySubscribers.CreateIterator(); It; ++It)
+		{
+			SetBit(It.Value(), Slot, false);
+			if (It.Value().Find(true) == INDEX_NONE)
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		for (const FName& Category : Categories)
+		{
+			if (Category == TEXT("*"))
+			{
+				SetBit(AllCategoriesSubscribers, Slot, true);
+			}
+			else
+			{
+				SetBit(CategorySubscribers.FindOrAdd(Category), Slot, true);
+			}
+		}
+	}
+
+	bool HasAnySubscriber(const FName& Category) const
+	{
+		FReadScopeLock ReadScopeLock(Lock);
+		return CategorySubscribers.Contains(Category) || AllCategoriesSubscribers.Find(true) != INDEX_NONE;
+	}
+
+	bool IsSubscribed(int32 Slot, const FName& Category) const
+	{
+		FReadScopeLock ReadScopeLock(Lock);
+		if (GetBit(AllCategoriesSubscribers, Slot))
+		{
+			return true;
+		}
+		const TBitArray<>* Subscribers = CategorySubscribers.Find(Category);
+		return Subscribers && GetBit(*Subscribers, Slot);
+	}
+
+private:
+
+	FPrintStringToConsoleSubscriptions()
+		: NumSlots(0)
+	{}
+
+	static void SetBit(TBitArray<>& Bits, int32 Slot, bool bValue)
+	{
+		if (Slot >= Bits.Num())
+		{
+			if (!bValue)
+			{
+				return;
+			}
+			while (Bits.Num() <= Slot)
+			{
+				Bits.Add(false);
+			}
+		}
+		Bits[Slot] = bValue;
+	}
+
+	static bool GetBit(const TBitArray<>& Bits, int32 Slot)
+	{
+		return Slot < Bits.Num() && Bits[Slot];
+	}
+
+private:
+
+	mutable FRWLock Lock;
+
+	/** [CategoryName] = Subscribers, only categories with at least one subscriber. */
+	TMap<FName, TBitArray<>> CategorySubscribers;
+
+	TBitArray<> AllCategoriesSubscribers;
+
+	TArray<int32> FreeSlots;
+
+	int32 NumSlots;
+};
+
+/**
+ * Client only. [World] = Categories set before the component of the local player was replicated.
+ * Per world, as the PIE clients of one process each have their own world and local player.
+ */
+static TMap<TWeakObjectPtr<UWorld>, TArray<FName>> GPendingLocalSubscribedCategories;
+
+UUEDebuggerNetComponent::UUEDebuggerNetComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, MessagesSent(0)
+	, MessagesDropped(0)
+	, BatchesSent(0)
+	, BytesSent(0)
+	, BatchesLost(0)
+	, PendingMessagesHead(0)
+	, NumPendingMessages(0)
+	, Sequence(0)
+	, SubscriptionSlot(INDEX_NONE)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+}
+
+UUEDebuggerNetComponent* UUEDebuggerNetComponent::FindOrAdd(APlayerController* PlayerController)
+{
+	if (!PlayerController)
+	{
+		return nullptr;
+	}
+
+	UUEDebuggerNetComponent* Component = PlayerController->FindComponentByClass<UUEDebuggerNetComponent>();
+	if (!Component && PlayerController->HasAuthority())
+	{
+		Component = NewObject<UUEDebuggerNetComponent>(PlayerController);
+		Component->RegisterComponent();
+	}
+	return Component;
+}
+
+void UUEDebuggerNetComponent::OnGameModePostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
+{
+	// Added at login, so the client can subscribe to its categories before the first message.
+	if (NewPlayer && !NewPlayer->IsLocalController())
+	{
+		FindOrAdd(NewPlayer);
+	}
+}
+
+bool UUEDebuggerNetComponent::ShouldBatchClientMessages(const APlayerController* PlayerController)
+{
+	return PlayerController && !PlayerController->IsLocalController() && PlayerController->HasAuthority() && CVarClientMessageBatch.GetValueOnGameThread() != 0;
+}
+
+void UUEDebuggerNetComponent::QueueClientMessage(const FString& Message, const FName& Type, float Duration)
+{
+	if (NumPendingMessages == 0)
+	{
+		GComponentsWithPendingMessages.Add(this);
+
+		// The capacity only changes between two frames.
+		const int32 MaxPendingMessages = FMath::Max(1, CVarClientMessageMaxPendingMessages.GetValueOnGameThread());
+		if (PendingMessages.Num() != MaxPendingMessages)
+		{
+			PendingMessages.SetNum(MaxPendingMessages);
+		}
+		PendingMessagesHead = 0;
+	}
+
+	const int32 Capacity = PendingMessages.Num();
+	int32 Index;
+	if (NumPendingMessages < Capacity)
+	{
+		Index = (PendingMessagesHead + NumPendingMessages) % Capacity;
+		NumPendingMessages++;
+	}
+	else
+	{
+		// Full, the oldest message is overwritten.
+		Index = PendingMessagesHead;
+		PendingMessagesHead = (PendingMessagesHead + 1) % Capacity;
+		MessagesDropped++;
+	}
+
+	// A message must fit in a batch, a character takes up to 2 bytes.
+	const int32 MaxMessageLength = FMath::Max(64, CVarClientMessageMaxBatchBytes.GetValueOnGameThread() / 2 - 256);
+
+	FPendingClientMessage& PendingMessage = PendingMessages[Index];
+	PendingMessage.Message = Message.Len() > MaxMessageLength ? Message.Left(MaxMessageLength) : Message;
+	PendingMessage.Type = Type;
+	PendingMessage.Duration = Duration;
+}
+
+void UUEDebuggerNetComponent::FlushAllPendingClientMessages()
+{
+	if (GComponentsWithPendingMessages.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<TWeakObjectPtr<UUEDebuggerNetComponent>> Components = MoveTemp(GComponentsWithPendingMessages);
+	GComponentsWithPendingMessages.Reset();
+
+	for (const TWeakObjectPtr<UUEDebuggerNetComponent>& Component : Components)
+	{
+		if (Component.IsValid())
+		{
+			Component->FlushPendingClientMessages();
+		}
+	}
+}
+
+void UUEDebuggerNetComponent::FlushPendingClientMessages()
+{
+	if (NumPendingMessages == 0)
+	{
+		return;
+	}
+
+	const int32 MaxBatchBytes = FMath::Max(1024, CVarClientMessageMaxBatchBytes.GetValueOnGameThread());
+
+	TArray<uint8> Payload;
+	FMemoryWriter Writer(Payload);
+
+	int32 NumMessages = 0;
+	Writer << NumMessages;
+	for (int32 Offset = 0; Offset < NumPendingMessages; Offset++)
+	{
+		FPendingClientMessage& PendingMessage = PendingMessages[(PendingMessagesHead + Offset) % PendingMessages.Num()];
+
+		const int32 MessageStart = Payload.Num();
+		Writer << PendingMessage.Message;
+		Writer << PendingMessage.Type;
+		Writer << PendingMessage.Duration;
+
+		// Too large for this batch, sent first and the message starts the next one.
+		if (Payload.Num() > MaxBatchBytes && NumMessages > 0)
+		{
+			Payload.SetNum(MessageStart, false);
+			SendMessageBatch(Payload, NumMessages);
+
+			Payload.Reset();
+			Writer.Seek(0);
+			NumMessages = 0;
+			Writer << NumMessages;
+			Writer << PendingMessage.Message;
+			Writer << PendingMessage.Type;
+			Writer << PendingMessage.Duration;
+		}
+		NumMessages++;
+	}
+	NumPendingMessages = 0;
+	PendingMessagesHead = 0;
+
+	SendMessageBatch(Payload, NumMessages);
+}
+
+void UUEDebuggerNetComponent::SendMessageBatch(TArray<uint8>& Payload, int32 NumMessages)
+{
+	FMemory::Memcpy(Payload.GetData(), &NumMessages, sizeof(NumMessages));
+
+	int32 UncompressedSize = 0;
+	if (Payload.Num() > CVarClientMessageCompressionThreshold.GetValueOnGameThread())
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Payload.Num());
+		TArray<uint8> CompressedPayload;
+		CompressedPayload.SetNumUninitialized(CompressedSize);
+
+		if (FCompression::CompressMemory(NAME_Zlib, CompressedPayload.GetData(), CompressedSize, Payload.GetData(), Payload.Num()) && CompressedSize < Payload.Num())
+		{
+			CompressedPayload.SetNum(CompressedSize, false);
+			UncompressedSize = Payload.Num();
+			Payload = MoveTemp(CompressedPayload);
+		}
+	}
+
+	++Sequence;
+	if (CVarClientMessageUnreliable.GetValueOnGameThread() != 0)
+	{
+		ClientReceiveMessageBatchUnreliable(Payload, UncompressedSize, Sequence);
+	}
+	else
+	{
+		ClientReceiveMessageBatch(Payload, UncompressedSize, Sequence);
+	}
+
+	MessagesSent += NumMessages;
+	BatchesSent++;
+	BytesSent += Payload.Num();
+}
+
+bool UUEDebuggerNetComponent::HasAnySubscriber(const FName& CategoryName)
+{
+	return FPrintStringToConsoleSubscriptions::Get().HasAnySubscriber(CategoryName);
+}
+
+bool UUEDebuggerNetComponent::WantsCategory(const FName& CategoryName, bool bServerCategoryEnabled) const
+{
+	if (SubscriptionSlot == INDEX_NONE)
+	{
+		return bServerCategoryEnabled;
+	}
+	return FPrintStringToConsoleSubscriptions::Get().IsSubscribed(SubscriptionSlot, CategoryName);
+}
+
+void UUEDebuggerNetComponent::SetLocalSubscribedCategories(UWorld* World, const TArray<FName>& Categories)
+{
+	if (!World || World->GetNetMode() != NM_Client)
+	{
+		UE_LOG(LogUEDebuggerPrintStringToConsole, Warning, TEXT("UEDebugger.Subscribe is only used by clients, use EnableDebug.PrintStringToConsole on server or standalone."));
+		return;
+	}
+
+	// More categories would be rejected by the server.
+	TArray<FName> SubscribedCategories = Categories;
+	if (SubscribedCategories.Num() > MaxSubscribedCategories)
+	{
+		UE_LOG(LogUEDebuggerPrintStringToConsole, Warning, TEXT("UEDebugger.Subscribe: only the first %d of %d categories are subscribed."), MaxSubscribedCategories, SubscribedCategories.Num());
+		SubscribedCategories.SetNum(MaxSubscribedCategories);
+	}
+
+	// The worlds of the ended PIE sessions.
+	for (auto It = GPendingLocalSubscribedCategories.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	APlayerController* PlayerController = World->GetFirstPlayerController();
+	UUEDebuggerNetComponent* Component = PlayerController ? PlayerController->FindComponentByClass<UUEDebuggerNetComponent>() : nullptr;
+	if (Component && Component->HasBegunPlay())
+	{
+		Component->ServerSetSubscribedCategories(SubscribedCategories);
+		GPendingLocalSubscribedCategories.Remove(World);
+	}
+	else
+	{
+		// Sent when the component of the local player of this world begins play.
+		GPendingLocalSubscribedCategories.Add(World, SubscribedCategories);
+	}
+
+	UE_LOG(LogUEDebuggerPrintStringToConsole, Log, TEXT("UEDebugger.Subscribe: %d categories%s."), SubscribedCategories.Num(), SubscribedCategories.Num() == 0 ? TEXT(", following the categories of the server") : TEXT(""));
+}
+
+void UUEDebuggerNetComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	if (PlayerController && PlayerController->IsLocalController() && !PlayerController->HasAuthority())
+	{
+		TArray<FName> PendingCategories;
+		if (GPendingLocalSubscribedCategories.RemoveAndCopyValue(GetWorld(), PendingCategories))
+		{
+			ServerSetSubscribedCategories(PendingCategories);
+		}
+	}
+}
+
+void UUEDebuggerNetComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (SubscriptionSlot != INDEX_NONE)
+	{
+		FPrintStringToConsoleSubscriptions::Get().ReleaseSlot(SubscriptionSlot);
+		SubscriptionSlot = INDEX_NONE;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UUEDebuggerNetComponent::ServerSetSubscribedCategories_Validate(const TArray<FName>& Categories)
+{
+	// Bounds the category table of the server, whatever the client sends.
+	return Categories.Num() <= MaxSubscribedCategories;
+}
+
+void UUEDebuggerNetComponent::ServerSetSubscribedCategories_Implementation(const TArray<FName>& Categories)
+{
+	if (Categories.Num() == 0)
+	{
+		if (SubscriptionSlot != INDEX_NONE)
+		{
+			FPrintStringToConsoleSubscriptions::Get().ReleaseSlot(SubscriptionSlot);
+			SubscriptionSlot = INDEX_NONE;
+		}
+		return;
+	}
+
+	if (SubscriptionSlot == INDEX_NONE)
+	{
+		SubscriptionSlot = FPrintStringToConsoleSubscriptions::Get().AllocateSlot();
+	}
+	FPrintStringToConsoleSubscriptions::Get().SetCategories(SubscriptionSlot, Categories);
+}
+
+void UUEDebuggerNetComponent::ClientReceiveMessageBatch_Implementation(const TArray<uint8>& Payload, int32 UncompressedSize, int32 InSequence)
+{
+	ReceiveMessageBatch(Payload, UncompressedSize, InSequence);
+}
+
+void UUEDebuggerNetComponent::ClientReceiveMessageBatchUnreliable_Implementation(const TArray<uint8>& Payload, int32 UncompressedSize, int32 InSequence)
+{
+	ReceiveMessageBatch(Payload, UncompressedSize, InSequence);
+}
+
+void UUEDebuggerNetComponent::ReceiveMessageBatch(const TArray<uint8>& Payload, int32 UncompressedSize, int32 InSequence)
+{
+	// Batches sent before the last received one are late, their messages are older than the ones already printed.
+	const int32 SequenceDelta = InSequence - Sequence;
+	if (SequenceDelta <= 0)
+	{
+		BatchesLost++;
+		return;
+	}
+	BatchesLost += SequenceDelta - 1;
+	Sequence = InSequence;
+
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	if (!PlayerController)
+	{
+		return;
+	}
+
+	TArray<uint8> UncompressedPayload;
+	const TArray<uint8>* Messages = &Payload;
+	if (UncompressedSize > 0)
+	{
+		UncompressedPayload.SetNumUninitialized(UncompressedSize);
+		if (!FCompression::UncompressMemory(NAME_Zlib, UncompressedPayload.GetData(), UncompressedSize, Payload.GetData(), Payload.Num()))
+		{
+			UE_LOG(LogUEDebuggerPrintStringToConsole, Warning, TEXT("Failed to uncompress a batch of PrintStringToConsole messages (Sequence = %d)."), InSequence);
+			return;
+		}
+		Messages = &UncompressedPayload;
+	}
+
+	FMemoryReader Reader(*Messages);
+
+	int32 NumMessages = 0;
+	Reader << NumMessages;
+	for (int32 Index = 0; Index < NumMessages && !Reader.IsError(); Index++)
+	{
+		FString Message;
+		FName Type;
+		float Duration = 0.0f;
+		Reader << Message;
+		Reader << Type;
+		Reader << Duration;
+
+		if (!Reader.IsError())
+		{
+			PlayerController->ClientMessage(Message, Type, Duration);
+		}
+	}
+}
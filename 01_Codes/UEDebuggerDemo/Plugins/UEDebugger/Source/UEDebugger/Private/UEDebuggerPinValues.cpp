@@ -0,0 +1,497 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerPinValues.h"
+#include "UEDebuggerBPLibrary.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UnrealType.h"
+#include "UObject/EnumProperty.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarPinValueMaxElements(
+	TEXT("UEDebugger.PinValue.MaxElements"),
+	8,
+	TEXT("Maximum number of elements of a container (or fields of a struct) formatted for a pin value on the screen and in the log."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarPinValueMaxDepth(
+	TEXT("UEDebugger.PinValue.MaxDepth"),
+	2,
+	TEXT("Maximum depth of the containers and structs formatted for a pin value on the screen and in the log, deeper values are shown as \"...\"."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarPinValueMaxChars(
+	TEXT("UEDebugger.PinValue.MaxChars"),
+	256,
+	TEXT("Maximum number of characters of a pin value on the screen and in the log."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarPinValueHistorySize(
+	TEXT("UEDebugger.PinValue.HistorySize"),
+	64,
+	TEXT("Number of recent breakpoint hits whose pin values can be expanded with \"UEDebugger.ExpandValue\"."),
+	ECVF_Default);
+
+static FAutoConsoleCommand CCmdExpandValue(
+	TEXT("UEDebugger.ExpandValue"),
+	TEXT("Arguments: <[Instance:]HitIndex> <PinName>\n")
+	TEXT("Writes the full value of a pin of a recent breakpoint hit to the log. HitIndex is the number in parentheses of the printed hit, e.g. 42 for [123456(42)].\n")
+	TEXT("The hits are numbered per PIE instance, e.g. \"Client2:42\", the most recent hit of any instance without Instance."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() < 2)
+			{
+				UE_LOG(LogUEDebuggerPrintStringToConsole, Warning, TEXT("Usage: UEDebugger.ExpandValue <[Instance:]HitIndex> <PinName>"));
+				return;
+			}
+
+			FString InstanceString;
+			FString HitIndexString = Args[0];
+			Args[0].Split(TEXT(":"), &InstanceString, &HitIndexString);
+
+			const FName InstanceName = InstanceString.IsEmpty() ? NAME_None : FName(*InstanceString);
+			const int64 HitIndex = FCString::Atoi64(*HitIndexString);
+			TSharedPtr<FUEDebuggerPinValues> PinValues = FUEDebuggerPinValueHistory::Get().Find(InstanceName, HitIndex);
+			if (!PinValues.IsValid())
+			{
+				UE_LOG(LogUEDebuggerPrintStringToConsole, Warning, TEXT("UEDebugger.ExpandValue: hit %s is not in the history anymore, see UEDebugger.PinValue.HistorySize."), *Args[0]);
+				return;
+			}
+
+			// Pin names may contain spaces.
+			FString PinName;
+			for (int32 ArgIndex = 1; ArgIndex < Args.Num(); ArgIndex++)
+			{
+				PinName += (ArgIndex > 1 ? TEXT(" ") : TEXT("")) + Args[ArgIndex];
+			}
+			const int32 PinIndex = PinValues->FindByDisplayName(PinName);
+			if (PinIndex == INDEX_NONE)
+			{
+				UE_LOG(LogUEDebuggerPrintStringToConsole, Warning, TEXT("UEDebugger.ExpandValue: hit %s has no pin %s."), *Args[0], *PinName);
+				return;
+			}
+
+			TStringBuilder<4096> Builder;
+			PinValues->AppendPinString(Builder, PinIndex, true);
+			UE_LOG(LogUEDebuggerPrintStringToConsole, Log, TEXT("[%s] %.*s"), *Args[0], Builder.Len(), Builder.GetData());
+		}));
+
+namespace UEDebuggerPinValues
+{
+	/** Number of garbage collections since the first capture, game thread only. */
+	static uint32 GarbageCollectionCount = 0;
+
+	static void BindGarbageCollectionCounter()
+	{
+		static bool bBound = false;
+		if (!bBound)
+		{
+			bBound = true;
+			FCoreUObjectDelegates::GetPostGarbageCollect().AddLambda([]()
+				{
+					GarbageCollectionCount++;
+				});
+		}
+	}
+}
+
+FUEDebuggerPinValues::~FUEDebuggerPinValues()
+{
+	for (FValue& Value : Values)
+	{
+		if (Value.HeapValue)
+		{
+			// Without its property the value can only be freed, its own allocations are lost.
+			if (const FProperty* Property = GetProperty(int32(&Value - Values.GetData())))
+			{
+				Property->DestroyValue(Value.HeapValue);
+			}
+			FMemory::Free(Value.HeapValue);
+		}
+		else if (Value.bWeakObject)
+		{
+			reinterpret_cast<FWeakObjectPtr*>(&Value.Inline)->~FWeakObjectPtr();
+		}
+	}
+}
+
+void FUEDebuggerPinValues::Capture(EUEDebuggerPinKind Kind, FName DisplayName, const FProperty* Property, const void* ValuePtr)
+{
+	check(IsInGameThread());
+
+	if (!Property || !ValuePtr)
+	{
+		return;
+	}
+
+	UEDebuggerPinValues::BindGarbageCollectionCounter();
+
+	FValue& Value = Values.AddDefaulted_GetRef();
+	Value.Kind = Kind;
+	Value.bInline = false;
+	Value.bWeakObject = false;
+	Value.bHasObjectReferences = false;
+	Value.DisplayName = DisplayName;
+	Value.Property = Property;
+	Value.PropertyOwner = Property->GetOwnerStruct();
+	Value.GarbageCollectionCount = UEDebuggerPinValues::GarbageCollectionCount;
+	Value.bFrozen = false;
+	Value.HeapValue = nullptr;
+
+	const int32 Size = Property->GetSize();
+
+	const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property);
+	if (ObjectProperty && Property->ArrayDim == 1)
+	{
+		Value.bInline = true;
+		Value.bWeakObject = true;
+		new (&Value.Inline) FWeakObjectPtr(ObjectProperty->GetObjectPropertyValue(ValuePtr));
+	}
+	else if (Property->HasAnyPropertyFlags(CPF_IsPlainOldData) && Size <= InlineValueSize)
+	{
+		Value.bInline = true;
+		FMemory::Memcpy(&Value.Inline, ValuePtr, Size);
+	}
+	else
+	{
+		TArray<const FStructProperty*> EncounteredStructProperties;
+		Value.bHasObjectReferences = Property->ContainsObjectReference(EncounteredStructProperties);
+
+		Value.HeapValue = FMemory::Malloc(Size, Property->GetMinAlignment());
+		Property->InitializeValue(Value.HeapValue);
+		Property->CopyCompleteValue(Value.HeapValue, ValuePtr);
+	}
+}
+
+const FProperty* FUEDebuggerPinValues::GetProperty(int32 Index) const
+{
+	const FValue& Value = Values[Index];
+
+	// Properties are only destroyed by a garbage collection.
+	if (Value.GarbageCollectionCount == UEDebuggerPinValues::GarbageCollectionCount || Value.PropertyOwner.IsValid())
+	{
+		return Value.Property;
+	}
+	return nullptr;
+}
+
+const void* FUEDebuggerPinValues::GetValuePtr(int32 Index) const
+{
+	if (!GetProperty(Index))
+	{
+		return nullptr;
+	}
+
+	const FValue& Value = Values[Index];
+	return Value.bInline ? static_cast<const void*>(&Value.Inline) : Value.HeapValue;
+}
+
+bool FUEDebuggerPinValues::GetNumericValue(int32 Index, double& OutValue) const
+{
+	const FProperty* Property = GetProperty(Index);
+	const void* ValuePtr = GetValuePtr(Index);
+	if (!Property || !ValuePtr || Property->ArrayDim != 1)
+	{
+		return false;
+	}
+
+	if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+	{
+		OutValue = BoolProperty->GetPropertyValue(ValuePtr) ? 1.0 : 0.0;
+		return true;
+	}
+	if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+	{
+		OutValue = (double)EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(ValuePtr);
+		return true;
+	}
+	if (const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property))
+	{
+		OutValue = NumericProperty->IsFloatingPoint() ? NumericProperty->GetFloatingPointPropertyValue(ValuePtr) : (double)NumericProperty->GetSignedIntPropertyValue(ValuePtr);
+		return true;
+	}
+	return false;
+}
+
+namespace UEDebuggerPinValues
+{
+	struct FFormatBudget
+	{
+		int32 MaxElements;
+		int32 MaxDepth;
+		int32 MaxChars;
+
+		/** Length of the builder before the value. */
+		int32 StartLength;
+
+		bool IsExhausted(const FStringBuilderBase& Builder) const
+		{
+			return Builder.Len() - StartLength >= MaxChars;
+		}
+	};
+
+	static void AppendBoundedValue(FStringBuilderBase& Builder, const FProperty* Property, const void* ValuePtr, int32 Depth, const FFormatBudget& Budget);
+
+	/** "[e0, e1]" or "[5000 items: first 8: e0, ..., e7 ...]", AppendElement(ElementIndex) appends the element ElementIndex. */
+	template<typename AppendElementType>
+	static void AppendElements(FStringBuilderBase& Builder, int32 NumElements, const TCHAR* Open, const TCHAR* Close, int32 Depth, const FFormatBudget& Budget, AppendElementType&& AppendElement)
+	{
+		if (Depth >= Budget.MaxDepth && NumElements > 0)
+		{
+			Builder.Appendf(TEXT("%s%d items ...%s"), Open, NumElements, Close);
+			return;
+		}
+
+		const int32 NumFormatted = FMath::Min(NumElements, Budget.MaxElements);
+
+		Builder << Open;
+		if (NumFormatted < NumElements)
+		{
+			Builder.Appendf(TEXT("%d items: first %d: "), NumElements, NumFormatted);
+		}
+
+		for (int32 ElementIndex = 0; ElementIndex < NumFormatted && !Budget.IsExhausted(Builder); ElementIndex++)
+		{
+			if (ElementIndex > 0)
+			{
+				Builder << TEXT(", ");
+			}
+			AppendElement(ElementIndex);
+		}
+
+		if (NumFormatted < NumElements)
+		{
+			Builder << TEXT(" ...");
+		}
+		Builder << Close;
+	}
+
+	static void AppendBoundedValue(FStringBuilderBase& Builder, const FProperty* Property, const void* ValuePtr, int32 Depth, const FFormatBudget& Budget)
+	{
+		if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			FScriptArrayHelper Helper(ArrayProperty, ValuePtr);
+			AppendElements(Builder, Helper.Num(), TEXT("["), TEXT("]"), Depth, Budget, [&](int32 ElementIndex)
+				{
+					AppendBoundedValue(Builder, ArrayProperty->Inner, Helper.GetRawPtr(ElementIndex), Depth + 1, Budget);
+				});
+		}
+		else if (const FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+		{
+			// Sparse, the Nth element is the Nth valid index.
+			FScriptSetHelper Helper(SetProperty, ValuePtr);
+			int32 SparseIndex = -1;
+			AppendElements(Builder, Helper.Num(), TEXT("{"), TEXT("}"), Depth, Budget, [&](int32 ElementIndex)
+				{
+					while (!Helper.IsValidIndex(++SparseIndex))
+					{
+					}
+					AppendBoundedValue(Builder, SetProperty->ElementProp, Helper.GetElementPtr(SparseIndex), Depth + 1, Budget);
+				});
+		}
+		else if (const FMapProperty* MapProperty = CastField<FMapProperty>(Property))
+		{
+			FScriptMapHelper Helper(MapProperty, ValuePtr);
+			int32 SparseIndex = -1;
+			AppendElements(Builder, Helper.Num(), TEXT("{"), TEXT("}"), Depth, Budget, [&](int32 ElementIndex)
+				{
+					while (!Helper.IsValidIndex(++SparseIndex))
+					{
+					}
+					AppendBoundedValue(Builder, MapProperty->KeyProp, Helper.GetKeyPtr(SparseIndex), Depth + 1, Budget);
+					Builder << TEXT(": ");
+					AppendBoundedValue(Builder, MapProperty->ValueProp, Helper.GetValuePtr(SparseIndex), Depth + 1, Budget);
+				});
+		}
+		else if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		{
+			TArray<const FProperty*, TInlineAllocator<16>> Fields;
+			for (TFieldIterator<FProperty> It(StructProperty->Struct); It; ++It)
+			{
+				Fields.Add(*It);
+			}
+
+			AppendElements(Builder, Fields.Num(), TEXT("("), TEXT(")"), Depth, Budget, [&](int32 FieldIndex)
+				{
+					const FProperty* Field = Fields[FieldIndex];
+					Builder << *Field->GetName() << TEXT("=");
+					AppendBoundedValue(Builder, Field, Field->ContainerPtrToValuePtr<void>(ValuePtr), Depth + 1, Budget);
+				});
+		}
+		else
+		{
+			FString ValueString;
+			Property->ExportTextItem(ValueString, ValuePtr, nullptr, nullptr, PPF_PropertyWindow | PPF_BlueprintDebugView);
+			Builder.Append(*ValueString, ValueString.Len());
+		}
+	}
+}
+
+void FUEDebuggerPinValues::FreezeObjectReferences()
+{
+	check(IsInGameThread());
+
+	for (int32 PinIndex = 0; PinIndex < Values.Num(); PinIndex++)
+	{
+		FValue& Value = Values[PinIndex];
+		if (!Value.bHasObjectReferences || Value.bFrozen || Value.GarbageCollectionCount != UEDebuggerPinValues::GarbageCollectionCount)
+		{
+			continue;
+		}
+
+		TStringBuilder<512> Builder;
+		AppendValueText(Builder, PinIndex, false);
+		Value.FrozenText = FString(Builder.Len(), Builder.GetData());
+
+		Builder.Reset();
+		AppendValueText(Builder, PinIndex, true);
+		Value.FrozenFullText = FString(Builder.Len(), Builder.GetData());
+
+		Value.bFrozen = true;
+	}
+}
+
+void FUEDebuggerPinValues::AppendValueText(FStringBuilderBase& Builder, int32 Index, bool bFullValue) const
+{
+	const FValue& Value = Values[Index];
+
+	// Formatted when the hit was printed, before the garbage collection could invalidate the references.
+	if (Value.bFrozen && Value.GarbageCollectionCount != UEDebuggerPinValues::GarbageCollectionCount)
+	{
+		const FString& FrozenText = bFullValue ? Value.FrozenFullText : Value.FrozenText;
+		Builder.Append(*FrozenText, FrozenText.Len());
+		return;
+	}
+
+	const FProperty* Property = GetProperty(Index);
+	if (!Property)
+	{
+		Builder << TEXT("(Blueprint recompiled)");
+		return;
+	}
+
+	if (Value.bWeakObject)
+	{
+		const UObject* Object = reinterpret_cast<const FWeakObjectPtr*>(&Value.Inline)->Get();
+		Builder << (Object ? *Object->GetName() : TEXT("None"));
+		return;
+	}
+
+	if (Value.bHasObjectReferences && Value.GarbageCollectionCount != UEDebuggerPinValues::GarbageCollectionCount)
+	{
+		Builder << TEXT("(stale, captured before garbage collection)");
+		return;
+	}
+
+	const uint8* ValuePtr = static_cast<const uint8*>(GetValuePtr(Index));
+
+	if (bFullValue)
+	{
+		FString ValueString;
+		Property->ExportTextItem(ValueString, ValuePtr, nullptr, nullptr, PPF_PropertyWindow | PPF_BlueprintDebugView);
+		Builder.Append(*ValueString, ValueString.Len());
+		return;
+	}
+
+	UEDebuggerPinValues::FFormatBudget Budget;
+	Budget.MaxElements = FMath::Max(1, CVarPinValueMaxElements.GetValueOnGameThread());
+	Budget.MaxDepth = FMath::Max(1, CVarPinValueMaxDepth.GetValueOnGameThread());
+	Budget.MaxChars = FMath::Max(16, CVarPinValueMaxChars.GetValueOnGameThread());
+	Budget.StartLength = Builder.Len();
+
+	if (Property->ArrayDim > 1)
+	{
+		// Static array, formatted as a container of its elements.
+		UEDebuggerPinValues::AppendElements(Builder, Property->ArrayDim, TEXT("["), TEXT("]"), 0, Budget, [&](int32 ElementIndex)
+			{
+				UEDebuggerPinValues::AppendBoundedValue(Builder, Property, ValuePtr + ElementIndex * Property->ElementSize, 1, Budget);
+			});
+	}
+	else
+	{
+		UEDebuggerPinValues::AppendBoundedValue(Builder, Property, ValuePtr, 0, Budget);
+	}
+
+	const int32 NumChars = Builder.Len() - Budget.StartLength;
+	if (NumChars > Budget.MaxChars)
+	{
+		Builder.RemoveSuffix(NumChars - Budget.MaxChars);
+		Builder << TEXT(" ...");
+	}
+}
+
+void FUEDebuggerPinValues::AppendPinString(FStringBuilderBase& Builder, int32 Index, bool bFullValue) const
+{
+	const FProperty* Property = GetProperty(Index);
+	const FString DisplayName = FName::NameToDisplayString(Values[Index].DisplayName.ToString(), CastField<FBoolProperty>(Property) != nullptr);
+
+	Builder << TEXT("\"");
+	Builder.Append(*DisplayName, DisplayName.Len());
+	Builder << TEXT("\" = \"");
+	AppendValueText(Builder, Index, bFullValue);
+	Builder << TEXT("\"");
+}
+
+int32 FUEDebuggerPinValues::FindByDisplayName(const FString& DisplayName) const
+{
+	const FString NameWithoutSpaces = DisplayName.Replace(TEXT(" "), TEXT(""));
+	for (int32 PinIndex = 0; PinIndex < Values.Num(); PinIndex++)
+	{
+		if (Values[PinIndex].DisplayName.ToString().Replace(TEXT(" "), TEXT("")).Equals(NameWithoutSpaces, ESearchCase::IgnoreCase))
+		{
+			return PinIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+FString FUEDebuggerPinValues::ToPinString(int32 Index) const
+{
+	TStringBuilder<256> Builder;
+	AppendPinString(Builder, Index);
+	return FString(Builder.Len(), Builder.GetData());
+}
+
+FUEDebuggerPinValueHistory& FUEDebuggerPinValueHistory::Get()
+{
+	static FUEDebuggerPinValueHistory Singleton;
+	return Singleton;
+}
+
+void FUEDebuggerPinValueHistory::Add(FName InstanceName, int64 HitIndex, const TSharedPtr<FUEDebuggerPinValues>& PinValues)
+{
+	check(IsInGameThread());
+
+	const int32 HistorySize = FMath::Max(0, CVarPinValueHistorySize.GetValueOnGameThread());
+	if (Entries.Num() != HistorySize)
+	{
+		Entries.Reset();
+		Entries.SetNum(HistorySize);
+		NextEntry = 0;
+	}
+
+	if (HistorySize == 0 || !PinValues.IsValid())
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries[NextEntry];
+	Entry.InstanceName = InstanceName;
+	Entry.HitIndex = HitIndex;
+	Entry.PinValues = PinValues;
+
+	NextEntry = (NextEntry + 1) % HistorySize;
+}
+
+TSharedPtr<FUEDebuggerPinValues> FUEDebuggerPinValueHistory::Find(FName InstanceName, int64 HitIndex) const
+{
+	// Most recent first.
+	for (int32 Age = 1; Age <= Entries.Num(); Age++)
+	{
+		const FEntry& Entry = Entries[(NextEntry - Age + Entries.Num()) % Entries.Num()];
+		if (Entry.PinValues.IsValid() && Entry.HitIndex == HitIndex && (InstanceName.IsNone() || Entry.InstanceName == InstanceName))
+		{
+			return Entry.PinValues;
+		}
+	}
+	return nullptr;
+}
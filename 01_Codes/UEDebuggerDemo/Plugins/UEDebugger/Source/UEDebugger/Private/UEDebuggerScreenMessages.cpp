@@ -0,0 +1,92 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerScreenMessages.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Crc.h"
+
+static TAutoConsoleVariable<int32> CVarCoalesceScreenMessages(
+	TEXT("UEDebugger.CoalesceScreenMessages"),
+	1,
+	TEXT("0: Every screen message of CustomPrintString adds a new line.\n")
+	TEXT("1: Repeated screen messages reuse their line and show a (xN) repeat counter."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMaxScreenLinesPerCategory(
+	TEXT("UEDebugger.MaxScreenLinesPerCategory"),
+	16,
+	TEXT("Maximum number of visible screen lines per category when UEDebugger.CoalesceScreenMessages is 1, the oldest line is removed. 0 for no limit."),
+	ECVF_Default);
+
+FUEDebuggerScreenMessages& FUEDebuggerScreenMessages::Get()
+{
+	static FUEDebuggerScreenMessages Singleton;
+	return Singleton;
+}
+
+void FUEDebuggerScreenMessages::AddMessage(FStringView Message, const FName& CategoryName, uint64 Key, float Duration, const FColor& DisplayColor)
+{
+	check(IsInGameThread());
+
+	if (!GEngine)
+	{
+		return;
+	}
+
+	if (CVarCoalesceScreenMessages.GetValueOnGameThread() == 0)
+	{
+		GEngine->AddOnScreenDebugMessage((uint64)-1, Duration, DisplayColor, FString(Message.Len(), Message.GetData()));
+		return;
+	}
+
+	// The category is part of the key, so a line always belongs to a single category. Never -1, which adds a new line.
+	const uint32 LineHash = Key != 0 ? GetTypeHash(Key) : FCrc::MemCrc32(Message.GetData(), Message.Len() * sizeof(TCHAR));
+	const uint64 ScreenKey = ((uint64(GetTypeHash(CategoryName)) << 32) | uint64(LineHash)) & ~(uint64(1) << 63);
+
+	const double NowSeconds = FPlatformTime::Seconds();
+
+	TArray<uint64>& Keys = CategoryLines.FindOrAdd(CategoryName);
+
+	// Forget the lines which already left the screen.
+	Keys.RemoveAll([this, NowSeconds](uint64 LineKey)
+		{
+			const FLine* Line = Lines.Find(LineKey);
+			if (Line && Line->ExpireSeconds >= NowSeconds)
+			{
+				return false;
+			}
+			Lines.Remove(LineKey);
+			return true;
+		});
+
+	int32 Count = 1;
+	if (FLine* Line = Lines.Find(ScreenKey))
+	{
+		Count = ++Line->Count;
+		Line->ExpireSeconds = NowSeconds + Duration;
+		Keys.RemoveSingle(ScreenKey);
+	}
+	else
+	{
+		Lines.Add(ScreenKey, FLine{ Count, NowSeconds + Duration });
+	}
+	Keys.Add(ScreenKey);
+
+	const int32 MaxLines = CVarMaxScreenLinesPerCategory.GetValueOnGameThread();
+	while (MaxLines > 0 && Keys.Num() > MaxLines)
+	{
+		const uint64 OldestKey = Keys[0];
+		Keys.RemoveAt(0, 1, false);
+		Lines.Remove(OldestKey);
+		GEngine->RemoveOnScreenDebugMessage(OldestKey);
+	}
+
+	if (Count > 1)
+	{
+		GEngine->AddOnScreenDebugMessage(ScreenKey, Duration, DisplayColor, FString::Printf(TEXT("%.*s (x%d)"), Message.Len(), Message.GetData(), Count));
+	}
+	else
+	{
+		GEngine->AddOnScreenDebugMessage(ScreenKey, Duration, DisplayColor, FString(Message.Len(), Message.GetData()));
+	}
+}
@@ -0,0 +1,140 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerScriptStacks.h"
+#include "UObject/Script.h"
+#include "UObject/Stack.h"
+
+FUEDebuggerScriptStacks& FUEDebuggerScriptStacks::Get()
+{
+	static FUEDebuggerScriptStacks Singleton;
+	return Singleton;
+}
+
+FUEDebuggerScriptStacks::FUEDebuggerScriptStacks()
+	: HashTable(4096)
+{
+}
+
+void FUEDebuggerScriptStacks::GetFrames(const FFrame& StackFrame, FFrameArray& OutFrames)
+{
+	const TArray<const FFrame*>& ScriptStack = FBlueprintContextTracker::Get().GetScriptStack();
+	for (const FFrame* Frame : ScriptStack)
+	{
+		if (Frame && Frame->Node)
+		{
+			OutFrames.Add(Frame);
+		}
+	}
+
+	if (OutFrames.Num() == 0 || OutFrames.Last() != &StackFrame)
+	{
+		OutFrames.Add(&StackFrame);
+	}
+}
+
+int32 FUEDebuggerScriptStacks::GetCodeOffset(const FFrame& Frame)
+{
+	return Frame.Code ? int32(Frame.Code - Frame.Node->Script.GetData()) : INDEX_NONE;
+}
+
+bool FUEDebuggerScriptStacks::Equals(const FStack& Stack, const FFrameArray& FrameArray) const
+{
+	if (Stack.NumFrames != FrameArray.Num())
+	{
+		return false;
+	}
+
+	for (int32 FrameIndex = 0; FrameIndex < Stack.NumFrames; FrameIndex++)
+	{
+		const FStackFrame& StackFrame = Frames[Stack.FirstFrame + FrameIndex];
+		const FFrame& Frame = *FrameArray[FrameIndex];
+		if (StackFrame.FunctionPtr != Frame.Node || StackFrame.CodeOffset != GetCodeOffset(Frame))
+		{
+			return false;
+		}
+	}
+
+	// Only checked on a match, the functions of the stack may have been replaced by a recompilation.
+	for (int32 FrameIndex = 0; FrameIndex < Stack.NumFrames; FrameIndex++)
+	{
+		if (Frames[Stack.FirstFrame + FrameIndex].Function.Get() != FrameArray[FrameIndex]->Node)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+uint32 FUEDebuggerScriptStacks::Intern(const FFrame& StackFrame)
+{
+	check(IsInGameThread());
+
+	FFrameArray FrameArray;
+	GetFrames(StackFrame, FrameArray);
+
+	uint32 Hash = 0;
+	for (const FFrame* Frame : FrameArray)
+	{
+		Hash = HashCombine(Hash, HashCombine(PointerHash(Frame->Node), ::GetTypeHash(GetCodeOffset(*Frame))));
+	}
+
+	for (uint32 StackIndex = HashTable.First(Hash); HashTable.IsValid(StackIndex); StackIndex = HashTable.Next(StackIndex))
+	{
+		const FStack& Stack = Stacks[StackIndex];
+		if (Stack.Hash == Hash && Equals(Stack, FrameArray))
+		{
+			return StackIndex + 1;
+		}
+	}
+
+	const int32 StackIndex = Stacks.Num();
+	FStack& Stack = Stacks.AddDefaulted_GetRef();
+	Stack.Hash = Hash;
+	Stack.FirstFrame = Frames.Num();
+	Stack.NumFrames = FrameArray.Num();
+
+	for (const FFrame* Frame : FrameArray)
+	{
+		FStackFrame& NewFrame = Frames.AddDefaulted_GetRef();
+		NewFrame.FunctionPtr = Frame->Node;
+		NewFrame.Function = Frame->Node;
+		NewFrame.CodeOffset = GetCodeOffset(*Frame);
+	}
+
+	// Rendered now, while the functions are alive.
+	Render(Stack);
+
+	HashTable.Add(Hash, StackIndex);
+	return StackIndex + 1;
+}
+
+void FUEDebuggerScriptStacks::Render(FStack& Stack) const
+{
+	FUEDebuggerScriptStackText& Text = Stack.Text;
+
+	Text.StackTrace = TEXT("Script call stack:\n");
+	for (int32 FrameIndex = 0; FrameIndex < Stack.NumFrames; FrameIndex++)
+	{
+		const UFunction* Function = Frames[Stack.FirstFrame + FrameIndex].Function.Get();
+		Text.StackTrace += FString::Printf(TEXT("\t%s\n"), *GetFullNameSafe(Function));
+	}
+
+	auto GetDescription = [this, &Stack](int32 FrameIndex)
+	{
+		const UFunction* Function = Frames[Stack.FirstFrame + FrameIndex].Function.Get();
+		return Function ? Function->GetOuter()->GetName() + TEXT(".") + Function->GetName() : FString(TEXT("None"));
+	};
+
+	for (int32 FrameIndex = Stack.NumFrames - 1; FrameIndex >= 0; FrameIndex--)
+	{
+		Text.ScriptCallstack += TEXT("\t") + GetDescription(FrameIndex) + TEXT("\n");
+	}
+
+	Text.StackDescription = GetDescription(Stack.NumFrames - 1);
+	Text.RootDescription = GetDescription(0);
+}
+
+const FUEDebuggerScriptStackText* FUEDebuggerScriptStacks::FindText(uint32 StackId) const
+{
+	return Stacks.IsValidIndex(int32(StackId) - 1) ? &Stacks[StackId - 1].Text : nullptr;
+}
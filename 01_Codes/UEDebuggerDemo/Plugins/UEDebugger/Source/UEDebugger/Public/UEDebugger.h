@@ -6,12 +6,10 @@
 #include "Modules/ModuleInterface.h"
 #include "UEDebuggerBPLibrary.h"
 
-// #if NO_LOGGING
-// 	#define (WorldContextObject, InString, bPrintToConsole, bPrintToScreen, bPrintToLog, TextColor, Duration, CategoryName)  
-// #else
-
-#if defined(WITH_ASAN) && WITH_ASAN == 1 && PLATFORM_IOS
-#define UE_PSTC(WorldContextObject, InString, bPrintToConsole, bPrintToScreen, bPrintToLog, TextColor, Duration, CategoryName)  
+#if NO_LOGGING || UE_BUILD_SHIPPING || (defined(WITH_ASAN) && WITH_ASAN == 1 && PLATFORM_IOS)
+#define UE_PSTC(WorldContextObject, InString, bPrintToConsole, bPrintToScreen, bPrintToLog, TextColor, Duration, CategoryName)
+#define UE_PSTCF(WorldContextObject, CategoryName, Format, ...)
+#define UE_PSTCF_EX(WorldContextObject, bPrintToConsole, bPrintToScreen, bPrintToLog, TextColor, Duration, CategoryName, Format, ...)
 #else
     /**
      * A  macro that outputs a formatted message to Console of Client. and optionally, to the screen or to the log.
@@ -20,6 +18,7 @@
      * Use Console variable "EnableDebug.PrintStringToConsole 1" to enable all "UE_PSTC";
      * Use Console variable "EnableDebug.PrintStringToConsole 0" to disable all "UE_PSTC";
      * Use Console variable "EnableDebug.PrintStringToConsole CategoryName" to enable "UE_PSTC" for specified "CategoryName".
+     * Use Console variable "EnableDebug.PrintStringToConsole CategoryA,Prefix*,-CategoryB" to enable several categories or wildcards, "-" excludes a category or wildcard.
      *
      * Example01:
      * {    
@@ -46,8 +45,37 @@
 	{ \
 		UUEDebuggerBPLibrary::PrintStringToConsole(WorldContextObject, InString, bPrintToConsole, bPrintToScreen, bPrintToLog, TextColor, Duration, CategoryName);\
 	}
+
+    /**
+     * A lazy version of "UE_PSTC": the category is tested before the format arguments are evaluated,
+     * so a disabled category costs no FString::Printf, no ToString() and no allocation.
+     * Prints to Console of Client, to the screen and to the log, with the default color and duration of "PrintStringToConsole".
+     *
+     * Example01:
+     * {
+     *     static const FName CategoryName = FName("PSTC_ShowID");
+     *     UE_PSTCF(this, CategoryName, TEXT("PSTC_Name = %s | ID = %d"), *GetName(), Id);
+     * }
+     *
+     * @param	WorldContextObject  Often use "this" to it if "this" is a "UObject".
+     * @param	CategoryName	Use Console variable "EnableDebug.PrintStringToConsole CustomCategoryName" to enable "UE_PSTCF" for specified "CustomCategoryName". Prefer a static FName on hot paths.
+     * @param	Format			The format string of FString::Printf, only evaluated with the following arguments when the category is enabled.
+     */
+#define UE_PSTCF(WorldContextObject, CategoryName, Format, ...) \
+	UE_PSTCF_EX(WorldContextObject, true, true, true, FLinearColor(0.0, 1.0, 1.0), 1.f, CategoryName, Format, ##__VA_ARGS__)
+
+    /**
+     * "UE_PSTCF" with all the options of "UE_PSTC".
+     */
+#define UE_PSTCF_EX(WorldContextObject, bPrintToConsole, bPrintToScreen, bPrintToLog, TextColor, Duration, CategoryName, Format, ...) \
+	{ \
+		const FName& PSTC_CategoryName = CategoryName; \
+		if (UUEDebuggerBPLibrary::IsPrintStringToConsoleCategoryEnabled(PSTC_CategoryName)) \
+		{ \
+			UUEDebuggerBPLibrary::PrintStringToConsole(WorldContextObject, FString::Printf(Format, ##__VA_ARGS__), bPrintToConsole, bPrintToScreen, bPrintToLog, TextColor, Duration, PSTC_CategoryName); \
+		} \
+	}
 #endif
-// #endif
 
 class UEDEBUGGER_API FUEDebuggerModule : public IModuleInterface
 {
@@ -56,4 +84,12 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+
+	void OnEndFrame();
+
+	FDelegateHandle OnEndFrameHandle;
+
+	FDelegateHandle OnGameModePostLoginHandle;
 };
\ No newline at end of file
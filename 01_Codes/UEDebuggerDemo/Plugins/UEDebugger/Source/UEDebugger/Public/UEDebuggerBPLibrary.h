@@ -3,6 +3,8 @@
 #pragma once
 
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Misc/StringBuilder.h"
+#include "UEDebuggerPinValues.h"
 #include "UEDebuggerBPLibrary.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogUEDebuggerPrintStringToConsole, Log, All);
@@ -21,9 +23,20 @@ public:
 
 public:
 
-	FString ToLogString();
+	/** Appends the text of the log / of the screen to Builder, without any intermediate string. Use a TStringBuilder large enough to never allocate. */
+	void AppendLogString(FStringBuilderBase& Builder) const;
 
-	FString ToScreenString();
+	void AppendScreenString(FStringBuilderBase& Builder) const;
+
+	FString ToLogString() const;
+
+	FString ToScreenString() const;
+
+	/** Converts the raw PinValues to WatchedPinsStrings, InputParametersStrings and OutputParametersStrings, for the sinks which need strings. */
+	void ConvertPinValuesToStrings();
+
+	/** Copies the texts of StackId to PreFrameNameString, StackTraceString, ScriptCallstackString and StackDescriptionString, for the sinks which need strings. */
+	void ConvertScriptStackToStrings();
 
 public:
 
@@ -67,6 +80,10 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	FString NodeCustomFullNameString; // Use this for Print.
 
+	/** Hits of the node skipped by the rules of "UEDebugger.BreakpointSampling" since its previous printed hit. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int64 SuppressedHits = 0;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	TArray<FString> WatchedPinsStrings;
 
@@ -82,6 +99,12 @@ public:
 	FString InstigatorNameString;
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	FString InstigatorControllerNameString;
+
+	/** Raw values of the watched, input and output pins, only converted to text when formatted. Appended after the strings of the same list. */
+	TSharedPtr<FUEDebuggerPinValues> PinValues;
+
+	/** Id of the script stack in FUEDebuggerScriptStacks, its texts are used when the stack strings are empty. */
+	uint32 StackId = 0;
 };
 
 /*
@@ -98,8 +121,11 @@ class UEDEBUGGER_API UUEDebuggerBPLibrary : public UBlueprintFunctionLibrary
 	 * Use Console variable "EnableDebug.PrintStringToConsole 1" to enable all "PrintStringToConsole";
 	 * Use Console variable "EnableDebug.PrintStringToConsole 0" to disable all "PrintStringToConsole";
 	 * Use Console variable "EnableDebug.PrintStringToConsole CategoryName" to enable "PrintStringToConsole" for specified "CategoryName".
+	 * Use Console variable "EnableDebug.PrintStringToConsole CategoryA,Prefix*,-CategoryB" to enable several categories or wildcards, "-" excludes a category or wildcard.
+	 * A client can receive its own categories from the server with Console command "UEDebugger.Subscribe CategoryA CategoryB".
 	 *
      * If Server call this function, it will print the string to the Console of Client if bPrintToConsole is true. Use '`' key to open Console in Editor.
+     * Can be called from any thread: out of the game thread the message is queued and printed at the end of the frame.
 	 * Prints a string to the log, and optionally, to the screen
      * If Print To Log is true, it will be visible in the Output Log window.  Otherwise it will be logged only as 'Verbose', so it generally won't show up.
      *
@@ -115,6 +141,11 @@ class UEDEBUGGER_API UUEDebuggerBPLibrary : public UBlueprintFunctionLibrary
 	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext, DisplayName = "PrintStringToConsole", Keywords = "PrintString To Console", AdvancedDisplay = "2", DevelopmentOnly), Category = "UEDebugger | BlueprintLibraries")
 	static void PrintStringToConsole(UObject* WorldContextObject, const FString& InString = FString(TEXT("Hello")), bool bPrintToConsole = true, bool bPrintToScreen = true, bool bPrintToLog = true, FLinearColor TextColor = FLinearColor(0.0, 1.0, 1.0), float Duration = 1.f, const FName& CategoryName = FName(TEXT("Temp")));
 
+	/** Whether "PrintStringToConsole" of CategoryName is enabled, by the local category filter or by the subscription of a remote client.
+	 *  No allocation, "UE_PSTCF" uses it before formatting the string. Always false in NO_LOGGING.
+	 */
+	static bool IsPrintStringToConsoleCategoryEnabled(const FName& CategoryName);
+
     /** Register ConsoleCommandGroup. Could use the TAutoConsoleCommandGroup to register a new ConsoleCommandGroup in C++ to.
      */
     UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext, DisplayName = "RegisterConsoleCommandGroup", Keywords = "RegisterConsoleCommandGroup"), Category = "UEDebugger | BlueprintLibraries | ConsoleCommandGroup")
@@ -131,6 +162,12 @@ class UEDEBUGGER_API UUEDebuggerBPLibrary : public UBlueprintFunctionLibrary
 	UFUNCTION(BlueprintPure, meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext, DisplayName = "GetAllConsoleCommandGroupNames", Keywords = "GetAllConsoleCommandGroupNames"), Category = "UEDebugger | BlueprintLibraries | ConsoleCommandGroup")
 	static void GetAllConsoleCommandGroupNames(UObject* WorldContextObject, APlayerController* Player, TArray<FString>& AllConsoleCommandGroupNames);
 
+    /** Copies the names of all ConsoleCommandGroups into ConsoleCommandGroupNames only if a group was registered or unregistered since Serial was read,
+     *  so a widget can call it every tick and keep its own array. Pass the same Serial variable each time, it starts at 0 and is updated with the names.
+     */
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext, DisplayName = "GetConsoleCommandGroupNamesIfChanged", Keywords = "GetAllConsoleCommandGroupNames Serial Changed"), Category = "UEDebugger | BlueprintLibraries | ConsoleCommandGroup")
+	static void GetConsoleCommandGroupNamesIfChanged(UObject* WorldContextObject, UPARAM(ref) int32& Serial, UPARAM(ref) TArray<FString>& ConsoleCommandGroupNames, bool& bChanged);
+
     /** Enable ConsoleCommandGroup by name. Could use the TAutoConsoleCommandGroup to register a new ConsoleCommandGroup in C++ or use RegisterConsoleCommandGroup in blueprint.
      *  One of WorldContextObject and Player should be valid.
      */
@@ -143,6 +180,13 @@ class UEDEBUGGER_API UUEDebuggerBPLibrary : public UBlueprintFunctionLibrary
 	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext, DisplayName = "DisableConsoleCommandGroup", Keywords = "DisableConsoleCommandGroup"), Category = "UEDebugger | BlueprintLibraries | ConsoleCommandGroup")
 	static void DisableConsoleCommandGroup(UObject* WorldContextObject, APlayerController* Player, const FString& ConsoleCommandGroupName);
 
+    /** Enable ConsoleCommandGroup by name for a number of frames or seconds, then disable it automatically. Same as Console command "UEDebugger.EnableGroupFor".
+     *  One of WorldContextObject and Player should be valid.
+     *  @param	Duration			Number of frames if bDurationInFrames, otherwise number of seconds.
+     */
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext, DisplayName = "EnableConsoleCommandGroupFor", Keywords = "EnableConsoleCommandGroupFor"), Category = "UEDebugger | BlueprintLibraries | ConsoleCommandGroup")
+	static void EnableConsoleCommandGroupFor(UObject* WorldContextObject, APlayerController* Player, const FString& ConsoleCommandGroupName, float Duration, bool bDurationInFrames, bool& Succeed);
+
 public:
 
     UFUNCTION(BlueprintCallable, meta = (DisplayName = "DisableConsoleCommandGroup"), Category = "UEDebugger | BlueprintLibraries | UObject")
@@ -157,6 +201,7 @@ public:
 	/**
      * Prints a string to the log, and optionally, to the screen
      * If Print To Log is true, it will be visible in the Output Log window.  Otherwise it will be logged only as 'Verbose', so it generally won't show up.
+     * Can be called from any thread: out of the game thread the message is queued and printed at the end of the frame.
      *
      * @param	InString		The string to log out
      * @param	bPrintToScreen	Whether or not to print the output to the screen
@@ -164,9 +209,14 @@ public:
      * @param	bPrintToConsole	Whether or not to print the output to the console
      * @param	TextColor		Whether or not to print the output to the console
      * @param	Duration		The display duration (if Print to Screen is True). Using negative number will result in loading the duration time from the config.
+     * @param	CategoryName	Category of the screen line, the visible lines of a category are capped, see "UEDebugger.MaxScreenLinesPerCategory".
+     * @param	ScreenMessageKey	0 to coalesce the screen messages with the same text, otherwise the screen messages with the same key replace each other.
      */
 	// UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject", CallableWithoutWorldContext, Keywords = "Custom Print String", AdvancedDisplay = "2"), Category = "UEDebugger | BlueprintLibraries")
-	static void CustomPrintString(UObject* WorldContextObject, const FString& InString = FString(TEXT("Hello")), bool bPrintToScreen = true, bool bPrintToLog = true, FLinearColor TextColor = FLinearColor(0.0, 0.66, 1.0), float Duration = 2.f);
+	static void CustomPrintString(UObject* WorldContextObject, const FString& InString = FString(TEXT("Hello")), bool bPrintToScreen = true, bool bPrintToLog = true, FLinearColor TextColor = FLinearColor(0.0, 0.66, 1.0), float Duration = 2.f, const FName& CategoryName = NAME_None, uint64 ScreenMessageKey = 0);
+
+	/** Same as "CustomPrintString", for the text of a TStringBuilder. Only builds a FString for the sinks which need one (console and screen). */
+	static void CustomPrintStringView(UObject* WorldContextObject, FStringView InString, bool bPrintToScreen, bool bPrintToLog, FLinearColor TextColor, float Duration, const FName& CategoryName = NAME_None, uint64 ScreenMessageKey = 0);
 
 };
 
@@ -0,0 +1,57 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+
+/**
+ * Category filter of "PrintStringToConsole", compiled from Console variable "EnableDebug.PrintStringToConsole".
+ *
+ * The value of the Console variable is only parsed when it changes. Supported values (comma or space separated):
+ *     "0"                   : Disable all categories.
+ *     "1", "TRUE" or "*"    : Enable all categories.
+ *     "CategoryA,CategoryB" : Enable the specified categories.
+ *     "PSTC_*"              : Enable the categories matching the wildcard ('*' and '?').
+ *     "-CategoryA"          : Disable the specified category (or wildcard). Exclusions always win.
+ * If the value only contains exclusions, all other categories are enabled.
+ *
+ * IsCategoryEnabled() costs one hashed lookup of the FName and does not allocate.
+ * Only the first test of a category against wildcards allocates, its result is cached until the next rebuild.
+ */
+class UEDEBUGGER_API FPrintStringToConsoleCategoryFilter
+{
+public:
+
+	/** Returns the singleton, bound to Console variable "EnableDebug.PrintStringToConsole" on first use. */
+	static FPrintStringToConsoleCategoryFilter& Get();
+
+	/** Thread safe. */
+	bool IsCategoryEnabled(const FName& CategoryName) const;
+
+	/** Rebuild the filter from the value of Console variable "EnableDebug.PrintStringToConsole". */
+	void Rebuild(const FString& Value);
+
+private:
+
+	FPrintStringToConsoleCategoryFilter();
+
+	bool EvaluateWildcards(const FName& CategoryName) const;
+
+private:
+
+	/** Used to prevent concurrent access while the filter is rebuilt. */
+	mutable FRWLock Lock;
+
+	/** No category can be enabled, the early out of the default value "0". */
+	bool bDisableAll;
+
+	/** Categories which are neither listed nor matching a wildcard are enabled. */
+	bool bEnableAll;
+
+	TArray<FString> IncludedWildcards;
+	TArray<FString> ExcludedWildcards;
+
+	/** [CategoryName] = Enabled. Seeded with the listed categories, then filled on demand with the results of the wildcards. */
+	mutable TMap<FName, bool> ResolvedCategories;
+};
@@ -8,9 +8,11 @@
 #include "Misc/AssertionMacros.h"
 #include "Containers/UnrealString.h"
 #include "Logging/LogMacros.h"
+#include <atomic>
 
 class IConsoleCommandGroupObject;
 class APlayerController;
+class IConsoleVariable;
 
 /**
  * handles console command group, registered console command group are released on destruction
@@ -31,7 +33,34 @@ struct UEDEBUGGER_API IConsoleCommandGroupManager
 	 */
 	virtual bool IsNameRegistered(const FString& Name) const = 0;
 
-	virtual TArray<FString> GetAllConsoleCommandGroupObjectNames() const = 0;
+	/** The cached names, rebuilt only when a group is registered or unregistered. Valid until the end of the frame after the next change. */
+	virtual const TArray<FString>& GetAllConsoleCommandGroupObjectNames() const = 0;
+
+	/** Incremented each time a group is registered or unregistered, so a caller can keep its own copy of the names until it changes. */
+	virtual uint32 GetConsoleCommandGroupObjectsSerial() const = 0;
+
+	/**
+	 * Enables a group now and disables it automatically when the window ends. Enabling a running group again restarts its window.
+	 * @param NumFrames		Length of the window in frames, used if > 0.
+	 * @param Seconds		Length of the window in seconds, used if NumFrames <= 0.
+	 * @return false if no group is named Name.
+	 */
+	virtual bool EnableConsoleCommandGroupObjectFor(const FString& Name, UObject* WorldContextObject, APlayerController* Player, int32 NumFrames, float Seconds) = 0;
+
+	/** Disables the groups whose window ended, called once per frame by FUEDebuggerModule. Game thread only. */
+	virtual void Tick() = 0;
+
+	/**
+	 * Forgets the running window of the group Name, if any, so it is not disabled a second time when the window ends.
+	 * Called when the group is disabled before the end of its window, or unregistered. Game thread only.
+	 */
+	virtual void CancelConsoleCommandGroupObjectWindow(const FString& Name) = 0;
+
+	/**
+	 * Reads the section [UEDebugger.ConsoleCommandGroups] of the Game ini files again, from the disk, and applies the differences:
+	 * the groups removed or changed since the last read are unregistered, the new or changed ones are registered. Game thread only.
+	 */
+	virtual void ReloadConfigConsoleCommandGroups() = 0;
 
 	/** Returns the singleton for the ConsoleCommandGroupManager **/
 	FORCEINLINE static IConsoleCommandGroupManager& Get()
@@ -62,6 +91,7 @@ class UEDEBUGGER_API FConsoleCommandGroupManager :public IConsoleCommandGroupMan
 public:
 	/** constructor */
 	FConsoleCommandGroupManager()
+		: Snapshot(new FRegistrySnapshot)
 	{
 	}
 
@@ -84,7 +114,17 @@ public:
 	 */
 	virtual bool IsNameRegistered(const FString& Name) const override;
 
-	virtual TArray<FString> GetAllConsoleCommandGroupObjectNames() const override;
+	virtual const TArray<FString>& GetAllConsoleCommandGroupObjectNames() const override;
+
+	virtual uint32 GetConsoleCommandGroupObjectsSerial() const override;
+
+	virtual bool EnableConsoleCommandGroupObjectFor(const FString& Name, UObject* WorldContextObject, APlayerController* Player, int32 NumFrames, float Seconds) override;
+
+	virtual void Tick() override;
+
+	virtual void CancelConsoleCommandGroupObjectWindow(const FString& Name) override;
+
+	virtual void ReloadConfigConsoleCommandGroups() override;
 
 	// ----------------------------------------------------
 
@@ -99,12 +139,102 @@ public:
 
 private: 
 
-	/** Map of ConsoleCommandGroupObjects, indexed by the name of that ConsoleCommandGroupObject */
+	/**
+	 * Immutable copy of the registry. Each change publishes a new one, so the lookups read it without locking.
+	 * The previous snapshot is deleted by Tick() one frame later, when no lookup can still be reading it.
+	 */
+	struct FRegistrySnapshot
+	{
+		/** [name] = pointer */
+		TMap<FString, IConsoleCommandGroupObject*> ConsoleCommandGroupObjects;
+
+		TArray<FString> Names;
+
+		uint32 Serial = 0;
+	};
+
+	const FRegistrySnapshot& GetSnapshot() const
+	{
+		return *Snapshot.load(std::memory_order_acquire);
+	}
+
+	/** Copies ConsoleCommandGroupObjects to a new snapshot, unless a batch defers it. Called with the lock held. */
+	void PublishSnapshot();
+
+	/** Deletes the snapshots replaced during an earlier frame, and releases the groups unregistered with them. Game thread only. */
+	void DeleteRetiredSnapshots();
+
+	std::atomic<const FRegistrySnapshot*> Snapshot;
+
+	struct FRetiredSnapshot
+	{
+		const FRegistrySnapshot* Snapshot;
+
+		uint64 Frame;
+
+		/** Groups unregistered by the change, still referenced by Snapshot: released no earlier than it is deleted. */
+		TArray<IConsoleCommandGroupObject*> ReleasedObjects;
+	};
+
+	/** Replaced snapshots, guarded by ConsoleCommandGroupObjectsSynchronizationObject. */
+	TArray<FRetiredSnapshot> RetiredSnapshots;
+
+	/** > 0 while ApplyConfigConsoleCommandGroups() registers a batch of groups, which is then published once. */
+	int32 DeferPublishSnapshotCount = 0;
+
+	/** Groups unregistered since the last published snapshot, handed to the snapshot retired by the next publication. */
+	TArray<IConsoleCommandGroupObject*> PendingReleases;
+
+	/**
+	 * The groups of the ini files are registered at the first lookup rather than at startup, so the number of groups does not add to the loading of the module
+	 * (and GConfig does not exist yet when the module is loaded).
+	 */
+	void LoadConfigConsoleCommandGroups() const;
+
+	/** @param Definitions	Values of "+Group=(Name=<Name>, Enable=\"<Command>;<Command>\", Disable=\"<Command>\")" */
+	void ApplyConfigConsoleCommandGroups(const TArray<FString>& Definitions);
+
+	struct FConfigConsoleCommandGroup
+	{
+		TArray<FString> ConsoleCommandsToEnable;
+		TArray<FString> ConsoleCommandsToDisable;
+
+		bool operator==(const FConfigConsoleCommandGroup& Other) const
+		{
+			return ConsoleCommandsToEnable == Other.ConsoleCommandsToEnable && ConsoleCommandsToDisable == Other.ConsoleCommandsToDisable;
+		}
+	};
+
+	/** [Name] = Commands of the groups registered from the ini files, the other groups are never changed by a reload. */
+	TMap<FString, FConfigConsoleCommandGroup> ConfigConsoleCommandGroups;
+
+	mutable std::atomic<bool> bConfigConsoleCommandGroupsLoaded{ false };
+
+	/** A group enabled by EnableConsoleCommandGroupObjectFor(). */
+	struct FTimedConsoleCommandGroup
+	{
+		FString Name;
+
+		TWeakObjectPtr<UObject> WorldContextObject;
+		TWeakObjectPtr<APlayerController> Player;
+
+		/** The group is disabled at the end of this frame, or when the time reaches EndSeconds. */
+		uint64 EndFrame;
+		double EndSeconds;
+	};
+
+	/** Running windows, only touched by the game thread. Tick() is a single test when empty. */
+	TArray<FTimedConsoleCommandGroup> TimedConsoleCommandGroups;
+
+	/** Map of ConsoleCommandGroupObjects, indexed by the name of that ConsoleCommandGroupObject, only read by the writers, the lookups use the snapshot */
 	// [name] = pointer (pointer must not be 0)
 	TMap<FString, IConsoleCommandGroupObject*> ConsoleCommandGroupObjects;
 
+	/** [pointer] = name, the reverse of ConsoleCommandGroupObjects */
+	TMap<const IConsoleCommandGroupObject*, FString> ConsoleCommandGroupObjectNames;
+
 	/**
-	 * Used to prevent concurrent access to ConsoleCommandGroupObjects.
+	 * Used to prevent concurrent changes of ConsoleCommandGroupObjects, the lookups do not take it.
      **/
 	mutable FCriticalSection ConsoleCommandGroupObjectsSynchronizationObject;
 };
@@ -155,6 +285,25 @@ public:
 	friend class FConsoleCommandGroupManager;
 };
 
+/**
+ * A command of a console command group, parsed once: "<ConsoleVariable> <Value>" is set directly, the other commands are executed by the console.
+ * The variable is found by name each time, a module can unregister it (hot reload, unloading) or register it after the group was parsed.
+ */
+struct UEDEBUGGER_API FConsoleCommandGroupEntry
+{
+	/** Empty if Command is not of the form "<Name> <Value>". */
+	FString VariableName;
+
+	/** Value assigned to the variable. */
+	FString Value;
+
+	/** The command as registered, executed by the console if no writable console variable is named VariableName. */
+	FString Command;
+
+	/** @return the console variable set by the entry now, nullptr to execute Command. */
+	IConsoleVariable* FindVariable() const;
+};
+
 class UEDEBUGGER_API FConsoleCommandGroupObject : public IConsoleCommandGroupObject
 {
 public:
@@ -179,13 +328,40 @@ public:
 
 	/**
 	 *  should only be called by the manager, needs to be implemented for each instance
+	 *  The console variables are set directly, their current values are kept to be restored by Disable(). The other commands are executed by the console.
 	 */
 	virtual void Enable(UObject* WorldContextObject, APlayerController* Player) override;
 
 	/**
 	 *  should only be called by the manager, needs to be implemented for each instance
+	 *  Restores the console variables set by Enable(), reference counted with the other enabled groups which set them, then runs ConsoleCommandsToDisable
+	 *  (so a group only needs the commands which are not console variables there, e.g. "stat fps").
+	 *  Also ends the window of EnableConsoleCommandGroupObjectFor(), a toggle such as "stat fps" must not run again when it ends.
 	 */
 	virtual void Disable(UObject* WorldContextObject, APlayerController* Player) override;
+
+	/** Runs Commands through the console parser as Enable() and Disable() did before the commands were resolved, for "UEDebugger.BenchmarkConsoleCommandGroup". */
+	static void ExecuteConsoleCommands(UObject* WorldContextObject, APlayerController* Player, const TArray<FString>& Commands);
+
+private:
+
+	/** Parsed at the first Enable() or Disable() rather than at registration, most groups are never enabled. */
+	void ResolveCommands();
+
+	static void ResolveCommands(const TArray<FString>& Commands, TArray<FConsoleCommandGroupEntry>& OutEntries);
+
+	/** Gives back the console variables set by Enable(), to their values before Enable() or to the values of the groups enabled since. */
+	void RestoreSnapshot();
+
+private:
+
+	TArray<FConsoleCommandGroupEntry> EntriesToEnable;
+	TArray<FConsoleCommandGroupEntry> EntriesToDisable;
+
+	/** Names of the console variables set by Enable() and not restored yet. */
+	TArray<FString> SnapshotVariables;
+
+	bool bCommandsResolved = false;
 };
 
 /**
@@ -0,0 +1,92 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * One ordered log of the lines of "CustomPrintString" of all PIE instances (server and clients), enabled with "UEDebugger.MergedLog 1".
+ *
+ * Every instance writes into its own channel, stamped with FPlatformTime::Cycles64() and GFrameCounter; a channel only has its own lock,
+ * so the instances never contend with each other. At the end of the frame the channels are k-way merged by timestamp into a bounded ring
+ * of lines, which "UEDebugger.MergedLog.Show" writes to the log and "UEDebugger.MergedLog.Export" to a file.
+ * With "UEDebugger.MergedLog 2" the merged lines are also written to LogUEDebuggerMergedLog as they are merged.
+ */
+class UEDEBUGGER_API FUEDebuggerMergedLog
+{
+public:
+
+	/** Channel 0 is the world out of PIE, channel N + 1 the PIE instance N. The instances past the last channel share it. */
+	static constexpr int32 MaxChannels = 64;
+
+	static FUEDebuggerMergedLog& Get();
+
+	/** Whether "UEDebugger.MergedLog" records the lines, cheap enough to check before each line. */
+	static bool IsEnabled();
+
+	/**
+	 * Can be called from any thread.
+	 * @param PIEInstance	FWorldContext::PIEInstance of the world of the line, INDEX_NONE out of PIE.
+	 * @param Prefix		Prefix of the instance, e.g. "Client2: ".
+	 */
+	void Add(int32 PIEInstance, FStringView Prefix, FStringView Text);
+
+	/** Game thread only, called once per frame by FUEDebuggerModule. Moves the lines of all channels to the merged lines, in timestamp order. */
+	void Merge();
+
+	/** Writes the NumLines most recent merged lines to the log, all by default. */
+	void Show(int32 NumLines);
+
+	bool Export(const FString& Filename);
+
+	void Reset();
+
+private:
+
+	struct FRecord
+	{
+		uint64 Cycles = 0;
+		uint64 FrameCounter = 0;
+		FString Text;
+	};
+
+	struct FChannel
+	{
+		/** Only taken by the writers of this channel and once per frame by Merge(). */
+		FCriticalSection CriticalSection;
+
+		/** Lines of the current frame, in timestamp order. */
+		TArray<FRecord> Pending;
+
+		/** Lines being merged, swapped with Pending so the writers can go on. */
+		TArray<FRecord> Merging;
+	};
+
+	struct FCursor
+	{
+		int32 ChannelIndex;
+		int32 RecordIndex;
+	};
+
+	void FormatRecord(const FRecord& Record, FString& OutLine) const;
+
+	void AddMergedRecord(FRecord&& Record, bool bWriteToLog);
+
+private:
+
+	FChannel Channels[MaxChannels];
+
+	/** Bit N is set when channel N has pending lines, so Merge() only visits the active channels. */
+	std::atomic<uint64> PendingChannelMask{ 0 };
+
+	/** Ring of the merged lines, the next line is written at NextMergedRecord. */
+	TArray<FRecord> MergedRecords;
+
+	int32 NextMergedRecord = 0;
+
+	int64 NumMergedRecords = 0;
+
+	/** Timestamp of the first line, the merged lines are stamped relatively to it. */
+	std::atomic<uint64> StartCycles{ 0 };
+};
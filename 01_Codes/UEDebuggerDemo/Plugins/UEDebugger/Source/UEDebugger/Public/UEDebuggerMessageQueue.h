@@ -0,0 +1,132 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include <atomic>
+
+/**
+ * A message of "PrintStringToConsole" or "CustomPrintString" pushed from a thread other than the game thread.
+ */
+struct UEDEBUGGER_API FUEDebuggerQueuedMessage
+{
+	FUEDebuggerQueuedMessage()
+		: CategoryName(NAME_None)
+		, TextColor(FLinearColor::White)
+		, Duration(0.0f)
+		, ScreenMessageKey(0)
+		, bPrintToConsole(false)
+		, bPrintToScreen(false)
+		, bPrintToLog(false)
+		, bCustomPrintString(false)
+	{}
+
+	TWeakObjectPtr<UObject> WorldContextObject;
+
+	FString Message;
+
+	FName CategoryName;
+
+	FLinearColor TextColor;
+
+	float Duration;
+
+	/** Only used by "CustomPrintString". */
+	uint64 ScreenMessageKey;
+
+	bool bPrintToConsole;
+	bool bPrintToScreen;
+	bool bPrintToLog;
+
+	/** true: sent to "CustomPrintString". false: sent to "PrintStringToConsole". */
+	bool bCustomPrintString;
+};
+
+/**
+ * Multi-producer/single-consumer queue of the messages printed from worker threads.
+ *
+ * Every producer thread owns a bounded single-producer/single-consumer ring (its staging buffer), so pushes never contend
+ * with each other and never take a lock, except the first push of a thread which registers its staging buffer.
+ * The game thread drains all staging buffers once per frame (FCoreDelegates::OnEndFrame) through the sinks of UUEDebuggerBPLibrary,
+ * without holding the lock while the sinks run.
+ * When a staging buffer is full the message is dropped and counted, so the memory stays bounded.
+ * The staging buffer of a thread which exits is drained one last time and reused by the next thread which registers one.
+ */
+class UEDEBUGGER_API FUEDebuggerMessageQueue
+{
+public:
+
+	/** Number of messages of a staging buffer. Must be a power of two. */
+	static constexpr uint32 StagingBufferCapacity = 256;
+
+	static FUEDebuggerMessageQueue& Get();
+
+	~FUEDebuggerMessageQueue();
+
+	/**
+	 * Can be called from any thread.
+	 * @return false if the staging buffer of the calling thread is full, the message is then dropped and counted as overflow.
+	 */
+	bool Enqueue(FUEDebuggerQueuedMessage&& Message);
+
+	/** Game thread only. Sends all queued messages to "PrintStringToConsole" or "CustomPrintString". */
+	void Drain();
+
+	/** Total number of dropped messages. */
+	uint64 GetOverflowCount() const
+	{
+		return OverflowCount.load(std::memory_order_relaxed);
+	}
+
+private:
+
+	FUEDebuggerMessageQueue();
+
+	struct FStagingBuffer
+	{
+		FStagingBuffer()
+			: Head(0)
+			, Tail(0)
+			, bThreadExited(false)
+		{
+			Slots.SetNum(StagingBufferCapacity);
+		}
+
+		TArray<FUEDebuggerQueuedMessage> Slots;
+
+		/** Written by the producer thread only. */
+		std::atomic<uint32> Head;
+
+		/** Written by the game thread only. */
+		std::atomic<uint32> Tail;
+
+		/** Set by the producer thread when it exits, after its last push. */
+		std::atomic<bool> bThreadExited;
+	};
+
+	/** Thread local, tells the queue that the staging buffer of the thread can be recycled when the thread exits. */
+	struct FStagingBufferOwner
+	{
+		FStagingBuffer* StagingBuffer = nullptr;
+
+		~FStagingBufferOwner();
+	};
+
+	FStagingBuffer& GetStagingBufferOfCurrentThread();
+
+private:
+
+	/** Staging buffers of the producer threads, a buffer whose thread exited is moved to FreeStagingBuffers once drained. */
+	TArray<FStagingBuffer*> StagingBuffers;
+
+	/** Empty staging buffers of exited threads, given to the next threads which push a message. */
+	TArray<FStagingBuffer*> FreeStagingBuffers;
+
+	/** Only taken when a thread registers its staging buffer and when the game thread lists or recycles them, never while the sinks run. */
+	FCriticalSection StagingBuffersCriticalSection;
+
+	std::atomic<uint64> OverflowCount;
+
+	uint64 ReportedOverflowCount;
+};
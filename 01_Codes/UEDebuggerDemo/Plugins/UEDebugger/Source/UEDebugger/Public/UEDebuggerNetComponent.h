@@ -0,0 +1,142 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "UEDebuggerNetComponent.generated.h"
+
+class APlayerController;
+class AGameModeBase;
+
+/**
+ * Added by the server to the PlayerController of every remote client which receives "PrintStringToConsole" messages.
+ *
+ * Instead of one reliable "ClientMessage" RPC per message, the messages of a frame are collected per connection
+ * and flushed at the end of the frame as one batched RPC, compressed when it is large enough.
+ *
+ * Console variables:
+ *     "UEDebugger.ClientMessage.Batch 0/1"                  : Batch the messages of a frame (default 1).
+ *     "UEDebugger.ClientMessage.Unreliable 0/1"             : Send the batches unreliably, lost or late batches are counted by the client (default 0).
+ *     "UEDebugger.ClientMessage.MaxPendingMessages N"       : Messages kept per connection and frame, the oldest are dropped (default 256).
+ *     "UEDebugger.ClientMessage.CompressionThreshold Bytes" : Batches larger than this are compressed (default 512).
+ *     "UEDebugger.ClientMessage.MaxBatchBytes Bytes"        : The messages of a frame are split into batches of at most this size, so an RPC fits in a bunch (default 32768).
+ * Console command "UEDebugger.ClientMessageStats" prints the counters of every connection.
+ *
+ * A client can subscribe to its own categories with Console command "UEDebugger.Subscribe CategoryA CategoryB" ("*" for all categories),
+ * and go back to the categories of the server's "EnableDebug.PrintStringToConsole" with "UEDebugger.Subscribe".
+ * The server keeps a subscriber bitset per category, so a category wanted by no connection costs no string building and no RPC.
+ */
+UCLASS(ClassGroup = (UEDebugger))
+class UEDEBUGGER_API UUEDebuggerNetComponent : public UActorComponent
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	/** Server only. Returns the component of PlayerController, adds it if needed. */
+	static UUEDebuggerNetComponent* FindOrAdd(APlayerController* PlayerController);
+
+	/** Bound to FGameModeEvents::GameModePostLoginEvent by FUEDebuggerModule. */
+	static void OnGameModePostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+
+	/** Whether "PrintStringToConsole" should batch the messages of PlayerController. */
+	static bool ShouldBatchClientMessages(const APlayerController* PlayerController);
+
+	/** Server only. Queue the message, sent with the other messages of this frame. */
+	void QueueClientMessage(const FString& Message, const FName& Type, float Duration);
+
+	/** Sends the pending messages of every component. Called once per frame by FUEDebuggerModule. */
+	static void FlushAllPendingClientMessages();
+
+	/** Thread safe. Whether at least one client subscribed to CategoryName (or to all categories). */
+	static bool HasAnySubscriber(const FName& CategoryName);
+
+	/**
+	 * Server only. Whether the client of this component wants the messages of CategoryName.
+	 * @param bServerCategoryEnabled	Result of the server's category filter, used if the client did not subscribe to its own categories.
+	 */
+	bool WantsCategory(const FName& CategoryName, bool bServerCategoryEnabled) const;
+
+	/** Maximum number of categories a client can subscribe to, a larger subscription is rejected by the server. */
+	static constexpr int32 MaxSubscribedCategories = 64;
+
+	/** Client only. Replace the categories of the local player, empty to follow the categories of the server. */
+	static void SetLocalSubscribedCategories(UWorld* World, const TArray<FName>& Categories);
+
+	//~ Begin UActorComponent Interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End UActorComponent Interface
+
+public:
+
+	/** Number of messages sent to the client. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = "UEDebugger | Net")
+	int64 MessagesSent;
+
+	/** Number of messages dropped by the server before they were sent (drop-oldest policy). */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = "UEDebugger | Net")
+	int64 MessagesDropped;
+
+	/** Number of batches sent to the client. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = "UEDebugger | Net")
+	int64 BatchesSent;
+
+	/** Number of payload bytes sent to the client. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = "UEDebugger | Net")
+	int64 BytesSent;
+
+	/** Client only. Number of unreliable batches lost or received out of order. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = "UEDebugger | Net")
+	int64 BatchesLost;
+
+protected:
+
+	/**
+	 * @param Payload			Serialized messages, compressed with Zlib if UncompressedSize is not 0.
+	 * @param UncompressedSize	0 if Payload is not compressed.
+	 * @param InSequence		Increased for every batch, used to detect lost unreliable batches.
+	 */
+	UFUNCTION(Client, Reliable)
+	void ClientReceiveMessageBatch(const TArray<uint8>& Payload, int32 UncompressedSize, int32 InSequence);
+
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveMessageBatchUnreliable(const TArray<uint8>& Payload, int32 UncompressedSize, int32 InSequence);
+
+	/** @param Categories	Empty to follow the categories of the server, "*" for all categories. At most MaxSubscribedCategories. */
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerSetSubscribedCategories(const TArray<FName>& Categories);
+
+private:
+
+	void FlushPendingClientMessages();
+
+	/** @param Payload	Starts with the number of messages, patched with NumMessages. */
+	void SendMessageBatch(TArray<uint8>& Payload, int32 NumMessages);
+
+	void ReceiveMessageBatch(const TArray<uint8>& Payload, int32 UncompressedSize, int32 InSequence);
+
+private:
+
+	struct FPendingClientMessage
+	{
+		FString Message;
+		FName Type;
+		float Duration;
+	};
+
+	/** Ring buffer of "UEDebugger.ClientMessage.MaxPendingMessages" messages, the oldest is overwritten when it is full. */
+	TArray<FPendingClientMessage> PendingMessages;
+
+	/** Index of the oldest pending message in PendingMessages. */
+	int32 PendingMessagesHead;
+
+	int32 NumPendingMessages;
+
+	/** Sequence of the next batch on server, of the last received batch on client. */
+	int32 Sequence;
+
+	/** Server only. Slot of this connection in the subscriber bitsets, INDEX_NONE if it follows the categories of the server. */
+	int32 SubscriptionSlot;
+};
@@ -0,0 +1,165 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/StringBuilder.h"
+#include "UObject/WeakObjectPtr.h"
+
+class FProperty;
+class UStruct;
+
+/** Which list of a breakpoint hit a pin value belongs to. */
+enum class EUEDebuggerPinKind : uint8
+{
+	Watched,
+	Input,
+	Output,
+};
+
+/**
+ * Raw values of the pins of a breakpoint hit, keyed by the FProperty of the pin.
+ *
+ * The capture only copies the bytes of the property: plain old data up to InlineValueSize bytes (bool, int, float, FVector, FRotator...)
+ * is stored inline, other values (strings, containers, structs) are deep copied with the property.
+ * Nothing is converted to text until a sink asks for it, and numeric values can be read back without text.
+ *
+ * Object references are kept as weak pointers. Values which contain object references (e.g. an array of actors) can only be
+ * converted to text until the next garbage collection: FreezeObjectReferences() formats them before, for the sinks which read them later
+ * (flight recorder, "UEDebugger.ExpandValue"), otherwise they are shown as stale.
+ * Game thread only.
+ */
+class UEDEBUGGER_API FUEDebuggerPinValues
+{
+public:
+
+	static constexpr int32 InlineValueSize = 16;
+
+	FUEDebuggerPinValues() = default;
+	~FUEDebuggerPinValues();
+
+	FUEDebuggerPinValues(const FUEDebuggerPinValues&) = delete;
+	FUEDebuggerPinValues& operator=(const FUEDebuggerPinValues&) = delete;
+
+	/**
+	 * @param DisplayName	Name of the pin.
+	 * @param ValuePtr		Value of Property, e.g. Property->ContainerPtrToValuePtr<void>(Locals).
+	 */
+	void Capture(EUEDebuggerPinKind Kind, FName DisplayName, const FProperty* Property, const void* ValuePtr);
+
+	int32 Num() const
+	{
+		return Values.Num();
+	}
+
+	EUEDebuggerPinKind GetKind(int32 Index) const
+	{
+		return Values[Index].Kind;
+	}
+
+	FName GetDisplayName(int32 Index) const
+	{
+		return Values[Index].DisplayName;
+	}
+
+	/** nullptr if the Blueprint of the property was recompiled and collected since the capture. */
+	const FProperty* GetProperty(int32 Index) const;
+
+	/** nullptr if GetProperty() is nullptr. */
+	const void* GetValuePtr(int32 Index) const;
+
+	/** INDEX_NONE if no pin is named DisplayName (case insensitive, with or without spaces). */
+	int32 FindByDisplayName(const FString& DisplayName) const;
+
+	/** Bool, enum and numeric values only. */
+	bool GetNumericValue(int32 Index, double& OutValue) const;
+
+	/**
+	 * Appends the text of the value.
+	 * @param bFullValue	false: containers and structs are bounded by "UEDebugger.PinValue.MaxElements", "MaxDepth" and "MaxChars",
+	 *						e.g. "[5000 items: first 8: 1, 2, 3, 4, 5, 6, 7, 8 ...]". true: the whole value, as FKismetDebugUtilities::GetDebugInfo().
+	 */
+	void AppendValueText(FStringBuilderBase& Builder, int32 Index, bool bFullValue = false) const;
+
+	/**
+	 * Formats now the values which contain object references, bounded and full, the text is used once a garbage collection made the raw value unsafe.
+	 * Called when the hit is printed, the other values stay raw.
+	 */
+	void FreezeObjectReferences();
+
+	/** Appends "DisplayName" = "Value". */
+	void AppendPinString(FStringBuilderBase& Builder, int32 Index, bool bFullValue = false) const;
+
+	FString ToPinString(int32 Index) const;
+
+private:
+
+	struct FValue
+	{
+		EUEDebuggerPinKind Kind;
+
+		/** Value stored in Inline, otherwise in HeapValue. */
+		bool bInline;
+
+		/** Single object reference, stored as a FWeakObjectPtr in Inline. */
+		bool bWeakObject;
+
+		/** The value contains object references, not safe to read after a garbage collection. */
+		bool bHasObjectReferences;
+
+		FName DisplayName;
+
+		const FProperty* Property;
+
+		/** The property is destroyed with its function or class. */
+		TWeakObjectPtr<UStruct> PropertyOwner;
+
+		/** Number of garbage collections when the value was captured. */
+		uint32 GarbageCollectionCount;
+
+		/** FrozenText and FrozenFullText are set, see FreezeObjectReferences(). */
+		bool bFrozen;
+
+		FString FrozenText;
+		FString FrozenFullText;
+
+		TAlignedBytes<InlineValueSize, 16> Inline;
+
+		void* HeapValue;
+	};
+
+	TArray<FValue, TInlineAllocator<8>> Values;
+};
+
+/**
+ * The pin values of the most recent breakpoint hits, so a value truncated on the screen and in the log can be expanded in full
+ * from the captured raw data with Console command "UEDebugger.ExpandValue <HitIndex> <PinName>".
+ * HitIndex is the number in parentheses of the printed hit, e.g. 42 for "[123456(42)]".
+ * The number of kept hits is "UEDebugger.PinValue.HistorySize". Game thread only.
+ */
+class UEDEBUGGER_API FUEDebuggerPinValueHistory
+{
+public:
+
+	static FUEDebuggerPinValueHistory& Get();
+
+	/** @param InstanceName	PIE instance of the hit (e.g. "Client2"), the hits are numbered per instance. */
+	void Add(FName InstanceName, int64 HitIndex, const TSharedPtr<FUEDebuggerPinValues>& PinValues);
+
+	/** nullptr if the hit is not in the history anymore. With NAME_None, the most recent hit HitIndex of any instance. */
+	TSharedPtr<FUEDebuggerPinValues> Find(FName InstanceName, int64 HitIndex) const;
+
+private:
+
+	struct FEntry
+	{
+		FName InstanceName;
+		int64 HitIndex;
+		TSharedPtr<FUEDebuggerPinValues> PinValues;
+	};
+
+	/** Ring of the recent hits, the next hit is written at NextEntry. */
+	TArray<FEntry> Entries;
+
+	int32 NextEntry = 0;
+};
@@ -0,0 +1,47 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+
+/**
+ * Coalescing layer in front of GEngine->AddOnScreenDebugMessage(), used by "CustomPrintString".
+ *
+ * Every message gets a stable key, made of its category and of the hash of its text (or of the key given by the caller,
+ * e.g. the node of a breakpoint), so a repeated message reuses its line on the screen and shows a "(xN)" repeat counter,
+ * instead of adding a new line per call. The number of visible lines of a category is capped, the oldest line is removed.
+ * The cost of the screen output then depends on the number of distinct messages, not on the number of calls.
+ *
+ * Console variables:
+ *     "UEDebugger.CoalesceScreenMessages 0/1"  : Coalesce the repeated screen messages (default 1).
+ *     "UEDebugger.MaxScreenLinesPerCategory N" : Visible lines per category, 0 for no limit (default 16).
+ */
+class UEDEBUGGER_API FUEDebuggerScreenMessages
+{
+public:
+
+	static FUEDebuggerScreenMessages& Get();
+
+	/**
+	 * Game thread only.
+	 * @param Key	0 to coalesce the messages with the same text, otherwise the messages with the same key replace each other.
+	 */
+	void AddMessage(FStringView Message, const FName& CategoryName, uint64 Key, float Duration, const FColor& DisplayColor);
+
+private:
+
+	struct FLine
+	{
+		int32 Count;
+
+		/** FPlatformTime::Seconds() when the line leaves the screen. */
+		double ExpireSeconds;
+	};
+
+	/** [Screen message key] = Line */
+	TMap<uint64, FLine> Lines;
+
+	/** [CategoryName] = Keys of the visible lines, least recently updated first. */
+	TMap<FName, TArray<uint64>> CategoryLines;
+};
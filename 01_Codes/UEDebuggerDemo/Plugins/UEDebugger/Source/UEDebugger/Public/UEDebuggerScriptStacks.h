@@ -0,0 +1,95 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/HashTable.h"
+#include "UObject/WeakObjectPtr.h"
+
+struct FFrame;
+
+/** Texts of an interned script stack, as built by FFrame for every hit before. */
+struct UEDEBUGGER_API FUEDebuggerScriptStackText
+{
+	/** As FFrame::GetStackTrace(). */
+	FString StackTrace;
+
+	/** As FFrame::GetScriptCallstack(). */
+	FString ScriptCallstack;
+
+	/** FFrame::GetStackDescription() of the current frame. */
+	FString StackDescription;
+
+	/** FFrame::GetStackDescription() of the first frame of the script stack. */
+	FString RootDescription;
+};
+
+/**
+ * Hash-consed script stacks of the breakpoint hits.
+ * A stack is the list of (UFunction, code offset) of FBlueprintContextTracker::GetScriptStack(): interning it costs a hash and a compare,
+ * a new stack is rendered to text once, and a hit only keeps the 32 bit id of its stack.
+ * The stacks are never removed, so an id stays valid (with the texts of the functions at that time) after the functions are recompiled or unloaded.
+ * Game thread only.
+ */
+class UEDEBUGGER_API FUEDebuggerScriptStacks
+{
+public:
+
+	/** Never returned by Intern(). */
+	static constexpr uint32 InvalidStackId = 0;
+
+	static FUEDebuggerScriptStacks& Get();
+
+	/** Interns the script stack of StackFrame, StackFrame is added if it is not the last frame of FBlueprintContextTracker. */
+	uint32 Intern(const FFrame& StackFrame);
+
+	/** nullptr for InvalidStackId or an unknown id. */
+	const FUEDebuggerScriptStackText* FindText(uint32 StackId) const;
+
+	int32 Num() const { return Stacks.Num(); }
+
+private:
+
+	FUEDebuggerScriptStacks();
+
+	struct FStackFrame
+	{
+		/** Key of the frame. Function is compared too, so a new function allocated at the address of an old one is another stack. */
+		const UFunction* FunctionPtr;
+		TWeakObjectPtr<UFunction> Function;
+		int32 CodeOffset;
+	};
+
+	struct FStack
+	{
+		uint32 Hash;
+
+		/** Frames[FirstFrame, FirstFrame + NumFrames), the first frame first. */
+		int32 FirstFrame;
+		int32 NumFrames;
+
+		FUEDebuggerScriptStackText Text;
+	};
+
+	/** Frames of the script stack of StackFrame, without allocation for the usual depths. */
+	typedef TArray<const FFrame*, TInlineAllocator<32>> FFrameArray;
+
+	static void GetFrames(const FFrame& StackFrame, FFrameArray& OutFrames);
+
+	static int32 GetCodeOffset(const FFrame& Frame);
+
+	bool Equals(const FStack& Stack, const FFrameArray& FrameArray) const;
+
+	void Render(FStack& Stack) const;
+
+private:
+
+	/** Stacks[StackId - 1] */
+	TArray<FStack> Stacks;
+
+	/** Frames of all stacks. */
+	TArray<FStackFrame> Frames;
+
+	/** [Hash] -> index in Stacks. */
+	FHashTable HashTable;
+};
@@ -0,0 +1,675 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerBreakpointConditions.h"
+#include "UEDebuggerEditor.h"
+#include "UEDebuggerNodeCache.h"
+#include "GameFramework/Actor.h"
+#include "EdGraph/EdGraphNode.h"
+#include "EdGraphSchema_K2.h"
+#include "Engine/Blueprint.h"
+#include "Kismet2/KismetDebugUtilities.h"
+#include "UObject/Stack.h"
+#include "UObject/UnrealType.h"
+
+static FAutoConsoleCommand CCmdBreakpointCondition(
+	TEXT("UEDebugger.BreakpointCondition"),
+	TEXT("Arguments: <NodeWildcard> [Expression] / Clear\n")
+	TEXT("Only print the breakpoints of \"UEDebugger.BreakpointType 1\" matching NodeWildcard (title or print name of the node) when Expression is true.\n")
+	TEXT("Expression uses the pins of the node (by name without spaces, e.g. ReturnValue), the parameters and local variables of the function,\n")
+	TEXT("the variables of the Blueprint, Self, Owner and Instigator,\n")
+	TEXT("numbers, \"strings\", true/false, == != < <= > >= && || ! and parentheses, e.g. Health < 10 && Owner == \"BP_Enemy_3\".\n")
+	TEXT("Without Expression the condition of NodeWildcard is removed. Clear: remove all conditions."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() == 1 && Args[0].Equals(TEXT("Clear"), ESearchCase::IgnoreCase))
+			{
+				FUEDebuggerBreakpointConditions::Get().ClearConditions();
+				UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("UEDebugger.BreakpointCondition: conditions cleared"));
+				return;
+			}
+
+			if (Args.Num() < 1)
+			{
+				UE_LOG(LogUEDebuggerEditorModule, Warning, TEXT("Usage: UEDebugger.BreakpointCondition <NodeWildcard> [Expression] / Clear"));
+				return;
+			}
+
+			// The console splits the expression at the spaces.
+			FString Expression;
+			for (int32 ArgIndex = 1; ArgIndex < Args.Num(); ArgIndex++)
+			{
+				Expression += (ArgIndex > 1 ? TEXT(" ") : TEXT("")) + Args[ArgIndex];
+			}
+
+			FString Error;
+			FUEDebuggerBreakpointCondition SyntaxCheck;
+			if (!Expression.IsEmpty() && !SyntaxCheck.Compile(Expression, nullptr, nullptr, nullptr, nullptr, Error))
+			{
+				UE_LOG(LogUEDebuggerEditorModule, Warning, TEXT("UEDebugger.BreakpointCondition: %s"), *Error);
+				return;
+			}
+
+			FUEDebuggerBreakpointConditions::Get().SetCondition(Args[0], Expression);
+			UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("UEDebugger.BreakpointCondition: %s %s"), *Args[0], Expression.IsEmpty() ? TEXT("removed") : *Expression);
+		}));
+
+//////////////////////////////////////////////////////////////////////////
+// FUEDebuggerBreakpointCondition
+
+/**
+ * Recursive descent parser, emits the program in postfix order.
+ *     Or      := And ("||" And)*
+ *     And     := Unary ("&&" Unary)*
+ *     Unary   := "!" Unary | Compare
+ *     Compare := Operand (("==" | "!=" | "<" | "<=" | ">" | ">=") Operand)?
+ *     Operand := Number | String | Identifier | "(" Or ")"
+ * Without Function and Class the identifiers are not resolved, only the syntax is checked.
+ */
+struct FUEDebuggerBreakpointCondition::FParser
+{
+	FParser(const FString& InExpression, const UFunction* InFunction, const UClass* InClass, const UEdGraphNode* InNode, UBlueprint* InBlueprint, TArray<FInstruction>& InProgram)
+		: Expression(InExpression)
+		, Function(InFunction)
+		, Class(InClass)
+		, Node(InNode)
+		, Blueprint(InBlueprint)
+		, Program(InProgram)
+	{
+	}
+
+	bool ParseOr()
+	{
+		if (!ParseAnd())
+		{
+			return false;
+		}
+		while (MatchToken(TEXT("||")))
+		{
+			if (!ParseAnd())
+			{
+				return false;
+			}
+			Emit(EOp::Or);
+		}
+		return true;
+	}
+
+	bool ParseAnd()
+	{
+		if (!ParseUnary())
+		{
+			return false;
+		}
+		while (MatchToken(TEXT("&&")))
+		{
+			if (!ParseUnary())
+			{
+				return false;
+			}
+			Emit(EOp::And);
+		}
+		return true;
+	}
+
+	bool ParseUnary()
+	{
+		SkipSpaces();
+		if (Position < Expression.Len() && Expression[Position] == TCHAR('!') && !(Position + 1 < Expression.Len() && Expression[Position + 1] == TCHAR('=')))
+		{
+			Position++;
+			if (!ParseUnary())
+			{
+				return false;
+			}
+			Emit(EOp::Not);
+			return true;
+		}
+		return ParseCompare();
+	}
+
+	bool ParseCompare()
+	{
+		if (!ParseOperand())
+		{
+			return false;
+		}
+
+		// Two character operators first.
+		EOp Op;
+		if (MatchToken(TEXT("==")))
+		{
+			Op = EOp::Equal;
+		}
+		else if (MatchToken(TEXT("!=")))
+		{
+			Op = EOp::NotEqual;
+		}
+		else if (MatchToken(TEXT("<=")))
+		{
+			Op = EOp::LessEqual;
+		}
+		else if (MatchToken(TEXT(">=")))
+		{
+			Op = EOp::GreaterEqual;
+		}
+		else if (MatchToken(TEXT("<")))
+		{
+			Op = EOp::Less;
+		}
+		else if (MatchToken(TEXT(">")))
+		{
+			Op = EOp::Greater;
+		}
+		else
+		{
+			return true;
+		}
+
+		if (!ParseOperand())
+		{
+			return false;
+		}
+		Emit(Op);
+		return true;
+	}
+
+	bool ParseOperand()
+	{
+		SkipSpaces();
+		if (Position >= Expression.Len())
+		{
+			return Fail(TEXT("unexpected end of the expression"));
+		}
+
+		const TCHAR Char = Expression[Position];
+		if (Char == TCHAR('('))
+		{
+			Position++;
+			if (!ParseOr())
+			{
+				return false;
+			}
+			return MatchToken(TEXT(")")) || Fail(TEXT("missing )"));
+		}
+
+		if (Char == TCHAR('"'))
+		{
+			const int32 Start = ++Position;
+			while (Position < Expression.Len() && Expression[Position] != TCHAR('"'))
+			{
+				Position++;
+			}
+			if (Position >= Expression.Len())
+			{
+				return Fail(TEXT("missing \""));
+			}
+
+			FInstruction& Instruction = Emit(EOp::PushName);
+			Instruction.String = Expression.Mid(Start, Position - Start);
+			Instruction.Name = FName(*Instruction.String);
+			Position++;
+			return true;
+		}
+
+		if (FChar::IsDigit(Char) || Char == TCHAR('-') || Char == TCHAR('.'))
+		{
+			const int32 Start = Position++;
+			while (Position < Expression.Len() && (FChar::IsDigit(Expression[Position]) || Expression[Position] == TCHAR('.')))
+			{
+				Position++;
+			}
+			Emit(EOp::PushNumber).Number = FCString::Atod(*Expression.Mid(Start, Position - Start));
+			return true;
+		}
+
+		if (FChar::IsAlpha(Char) || Char == TCHAR('_'))
+		{
+			const int32 Start = Position;
+			while (Position < Expression.Len() && (FChar::IsAlnum(Expression[Position]) || Expression[Position] == TCHAR('_')))
+			{
+				Position++;
+			}
+			return ResolveIdentifier(Expression.Mid(Start, Position - Start));
+		}
+
+		return Fail(FString::Printf(TEXT("unexpected '%c'"), Char));
+	}
+
+	bool ResolveIdentifier(const FString& Identifier)
+	{
+		if (Identifier.Equals(TEXT("true"), ESearchCase::IgnoreCase) || Identifier.Equals(TEXT("false"), ESearchCase::IgnoreCase))
+		{
+			Emit(EOp::PushNumber).Number = Identifier.Equals(TEXT("true"), ESearchCase::IgnoreCase) ? 1.0 : 0.0;
+			return true;
+		}
+		if (Identifier.Equals(TEXT("Self"), ESearchCase::IgnoreCase))
+		{
+			Emit(EOp::PushSelf);
+			return true;
+		}
+		if (Identifier.Equals(TEXT("Owner"), ESearchCase::IgnoreCase))
+		{
+			Emit(EOp::PushOwner);
+			return true;
+		}
+		if (Identifier.Equals(TEXT("Instigator"), ESearchCase::IgnoreCase))
+		{
+			Emit(EOp::PushInstigator);
+			return true;
+		}
+
+		if (!Function && !Class)
+		{
+			// Syntax check only.
+			Emit(EOp::PushNumber);
+			return true;
+		}
+
+		if (const FProperty* Property = FindPinProperty(Identifier))
+		{
+			FInstruction& Instruction = Emit(EOp::PushPinProperty);
+			Instruction.Property = Property;
+			Instruction.Blueprint = Blueprint;
+			return true;
+		}
+
+		const FName PropertyName(*Identifier);
+		if (const FProperty* Property = Function ? FindFProperty<FProperty>(Function, PropertyName) : nullptr)
+		{
+			Emit(EOp::PushLocalProperty).Property = Property;
+			return true;
+		}
+		if (const FProperty* Property = Class ? FindFProperty<FProperty>(Class, PropertyName) : nullptr)
+		{
+			Emit(EOp::PushMemberProperty).Property = Property;
+			return true;
+		}
+
+		return Fail(FString::Printf(TEXT("%s is not a variable of %s"), *Identifier, Function ? *Function->GetName() : *GetNameSafe(Class)));
+	}
+
+	/** The property of the pin of Node named Identifier, by pin name or displayed name, case and spaces ignored. */
+	const FProperty* FindPinProperty(const FString& Identifier) const
+	{
+		if (!Node || !Blueprint)
+		{
+			return nullptr;
+		}
+
+		for (const UEdGraphPin* Pin : Node->Pins)
+		{
+			if (!Pin || Pin->bHidden || Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Exec)
+			{
+				continue;
+			}
+
+			const FString PinName = Pin->PinName.ToString().Replace(TEXT(" "), TEXT(""));
+			const FString DisplayName = Pin->PinFriendlyName.ToString().Replace(TEXT(" "), TEXT(""));
+			if (PinName.Equals(Identifier, ESearchCase::IgnoreCase) || (!DisplayName.IsEmpty() && DisplayName.Equals(Identifier, ESearchCase::IgnoreCase)))
+			{
+				return FKismetDebugUtilities::FindClassPropertyForPin(Blueprint, Pin);
+			}
+		}
+		return nullptr;
+	}
+
+	bool MatchToken(const TCHAR* Token)
+	{
+		SkipSpaces();
+		const int32 TokenLength = FCString::Strlen(Token);
+		if (FCString::Strncmp(*Expression + Position, Token, TokenLength) == 0)
+		{
+			Position += TokenLength;
+			return true;
+		}
+		return false;
+	}
+
+	void SkipSpaces()
+	{
+		while (Position < Expression.Len() && FChar::IsWhitespace(Expression[Position]))
+		{
+			Position++;
+		}
+	}
+
+	FInstruction& Emit(EOp Op)
+	{
+		FInstruction& Instruction = Program.AddDefaulted_GetRef();
+		Instruction.Op = Op;
+		Instruction.Number = 0.0;
+		Instruction.Property = nullptr;
+		Instruction.Blueprint = nullptr;
+		return Instruction;
+	}
+
+	bool Fail(const FString& Message)
+	{
+		if (Error.IsEmpty())
+		{
+			Error = FString::Printf(TEXT("%s (at %d in \"%s\")"), *Message, Position, *Expression);
+		}
+		return false;
+	}
+
+	const FString& Expression;
+	const UFunction* Function;
+	const UClass* Class;
+	const UEdGraphNode* Node;
+	UBlueprint* Blueprint;
+	TArray<FInstruction>& Program;
+
+	int32 Position = 0;
+	FString Error;
+};
+
+bool FUEDebuggerBreakpointCondition::Compile(const FString& Expression, const UFunction* Function, const UClass* Class, const UEdGraphNode* Node, UBlueprint* Blueprint, FString& OutError)
+{
+	Program.Reset();
+
+	FParser Parser(Expression, Function, Class, Node, Blueprint, Program);
+	bool bValid = Parser.ParseOr();
+	Parser.SkipSpaces();
+	if (bValid && Parser.Position != Expression.Len())
+	{
+		bValid = Parser.Fail(TEXT("unexpected characters"));
+	}
+
+	if (!bValid)
+	{
+		OutError = Parser.Error;
+		Program.Reset();
+	}
+	return bValid;
+}
+
+namespace UEDebuggerBreakpointCondition
+{
+	/** Value on the stack of the program, never owns memory. */
+	struct FValue
+	{
+		enum class EType : uint8
+		{
+			Invalid,
+			Number,
+			/** String literal of the expression, has Name and String. */
+			Literal,
+			Name,
+			String,
+			Object,
+		};
+
+		EType Type = EType::Invalid;
+		double Number = 0.0;
+		FName Name;
+		const FString* String = nullptr;
+		const UObject* Object = nullptr;
+	};
+
+	static FValue ReadProperty(const FProperty* Property, const void* Container)
+	{
+		FValue Value;
+		if (!Container)
+		{
+			return Value;
+		}
+
+		const void* ValuePtr = Property->ContainerPtrToValuePtr<void>(Container);
+		if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+		{
+			Value.Type = FValue::EType::Number;
+			Value.Number = BoolProperty->GetPropertyValue(ValuePtr) ? 1.0 : 0.0;
+		}
+		else if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+		{
+			Value.Type = FValue::EType::Number;
+			Value.Number = (double)EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(ValuePtr);
+		}
+		else if (const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property))
+		{
+			Value.Type = FValue::EType::Number;
+			Value.Number = NumericProperty->IsFloatingPoint() ? NumericProperty->GetFloatingPointPropertyValue(ValuePtr) : (double)NumericProperty->GetSignedIntPropertyValue(ValuePtr);
+		}
+		else if (const FNameProperty* NameProperty = CastField<FNameProperty>(Property))
+		{
+			Value.Type = FValue::EType::Name;
+			Value.Name = NameProperty->GetPropertyValue(ValuePtr);
+		}
+		else if (const FStrProperty* StrProperty = CastField<FStrProperty>(Property))
+		{
+			Value.Type = FValue::EType::String;
+			Value.String = &StrProperty->GetPropertyValue(ValuePtr);
+		}
+		else if (const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
+		{
+			Value.Type = FValue::EType::Object;
+			Value.Object = ObjectProperty->GetObjectPropertyValue(ValuePtr);
+		}
+		return Value;
+	}
+
+	static FValue MakeObject(const UObject* Object)
+	{
+		FValue Value;
+		Value.Type = FValue::EType::Object;
+		Value.Object = Object;
+		return Value;
+	}
+
+	static FValue MakeNumber(bool bValue)
+	{
+		FValue Value;
+		Value.Type = FValue::EType::Number;
+		Value.Number = bValue ? 1.0 : 0.0;
+		return Value;
+	}
+
+	static bool IsTrue(const FValue& Value)
+	{
+		switch (Value.Type)
+		{
+		case FValue::EType::Number:
+			return Value.Number != 0.0;
+		case FValue::EType::Object:
+			return Value.Object != nullptr;
+		case FValue::EType::Name:
+			return !Value.Name.IsNone();
+		case FValue::EType::String:
+		case FValue::EType::Literal:
+			return !Value.String->IsEmpty();
+		default:
+			return false;
+		}
+	}
+
+	/** Objects are compared by name, FName without building a string. */
+	static bool AreEqual(const FValue& A, const FValue& B)
+	{
+		if (A.Type == FValue::EType::Number || B.Type == FValue::EType::Number)
+		{
+			return A.Type == B.Type && A.Number == B.Number;
+		}
+		if (A.Type == FValue::EType::Object && B.Type == FValue::EType::Object)
+		{
+			return A.Object == B.Object;
+		}
+		if (A.Type == FValue::EType::String || B.Type == FValue::EType::String)
+		{
+			const FValue& StringValue = A.Type == FValue::EType::String ? A : B;
+			const FValue& OtherValue = A.Type == FValue::EType::String ? B : A;
+			switch (OtherValue.Type)
+			{
+			case FValue::EType::String:
+			case FValue::EType::Literal:
+				return StringValue.String->Equals(*OtherValue.String, ESearchCase::IgnoreCase);
+			case FValue::EType::Name:
+				return StringValue.String->Equals(OtherValue.Name.ToString(), ESearchCase::IgnoreCase);
+			case FValue::EType::Object:
+				return StringValue.String->Equals(GetNameSafe(OtherValue.Object), ESearchCase::IgnoreCase);
+			default:
+				return false;
+			}
+		}
+
+		auto GetName = [](const FValue& Value)
+		{
+			return Value.Type == FValue::EType::Object ? (Value.Object ? Value.Object->GetFName() : FName(NAME_None)) : Value.Name;
+		};
+		return A.Type != FValue::EType::Invalid && B.Type != FValue::EType::Invalid && GetName(A) == GetName(B);
+	}
+}
+
+bool FUEDebuggerBreakpointCondition::Evaluate(const UObject* ActiveObject, const FFrame& StackFrame) const
+{
+	using namespace UEDebuggerBreakpointCondition;
+
+	TArray<FValue, TInlineAllocator<16>> Stack;
+
+	const AActor* ActiveActor = Cast<AActor>(ActiveObject);
+
+	for (const FInstruction& Instruction : Program)
+	{
+		switch (Instruction.Op)
+		{
+		case EOp::PushNumber:
+			{
+				FValue& Value = Stack.AddDefaulted_GetRef();
+				Value.Type = FValue::EType::Number;
+				Value.Number = Instruction.Number;
+			}
+			break;
+		case EOp::PushName:
+			{
+				FValue& Value = Stack.AddDefaulted_GetRef();
+				Value.Type = FValue::EType::Literal;
+				Value.Name = Instruction.Name;
+				Value.String = &Instruction.String;
+			}
+			break;
+		case EOp::PushLocalProperty:
+			Stack.Add(ReadProperty(Instruction.Property, StackFrame.Locals));
+			break;
+		case EOp::PushMemberProperty:
+			Stack.Add(ReadProperty(Instruction.Property, StackFrame.Object));
+			break;
+		case EOp::PushPinProperty:
+			Stack.Add(ReadProperty(Instruction.Property, FUEDebuggerEditorModule::FindPinPropertyContainer(Instruction.Blueprint, StackFrame.Object, Instruction.Property)));
+			break;
+		case EOp::PushSelf:
+			Stack.Add(MakeObject(ActiveObject));
+			break;
+		case EOp::PushOwner:
+			Stack.Add(MakeObject(ActiveActor ? ActiveActor->GetOwner() : nullptr));
+			break;
+		case EOp::PushInstigator:
+			Stack.Add(MakeObject(ActiveActor ? ActiveActor->GetInstigator() : nullptr));
+			break;
+		case EOp::Not:
+			Stack.Last() = MakeNumber(!IsTrue(Stack.Last()));
+			break;
+		default:
+			{
+				// Binary operators.
+				const FValue B = Stack.Pop(false);
+				const FValue A = Stack.Pop(false);
+				const bool bNumbers = A.Type == FValue::EType::Number && B.Type == FValue::EType::Number;
+
+				bool bResult = false;
+				switch (Instruction.Op)
+				{
+				case EOp::And:			bResult = IsTrue(A) && IsTrue(B); break;
+				case EOp::Or:			bResult = IsTrue(A) || IsTrue(B); break;
+				case EOp::Equal:		bResult = AreEqual(A, B); break;
+				case EOp::NotEqual:		bResult = !AreEqual(A, B); break;
+				case EOp::Less:			bResult = bNumbers && A.Number < B.Number; break;
+				case EOp::LessEqual:	bResult = bNumbers && A.Number <= B.Number; break;
+				case EOp::Greater:		bResult = bNumbers && A.Number > B.Number; break;
+				case EOp::GreaterEqual:	bResult = bNumbers && A.Number >= B.Number; break;
+				default:
+					break;
+				}
+				Stack.Add(MakeNumber(bResult));
+			}
+			break;
+		}
+	}
+
+	return Stack.Num() == 1 && IsTrue(Stack[0]);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FUEDebuggerBreakpointConditions
+
+FUEDebuggerBreakpointConditions& FUEDebuggerBreakpointConditions::Get()
+{
+	static FUEDebuggerBreakpointConditions Singleton;
+	return Singleton;
+}
+
+void FUEDebuggerBreakpointConditions::SetCondition(const FString& NodeWildcard, const FString& Expression)
+{
+	Rules.RemoveAll([&NodeWildcard](const FRule& Rule)
+		{
+			return Rule.NodeWildcard.Equals(NodeWildcard, ESearchCase::IgnoreCase);
+		});
+
+	if (!Expression.IsEmpty())
+	{
+		FRule& Rule = Rules.AddDefaulted_GetRef();
+		Rule.NodeWildcard = NodeWildcard;
+		Rule.Expression = Expression;
+	}
+
+	RulesGeneration++;
+}
+
+void FUEDebuggerBreakpointConditions::ClearConditions()
+{
+	Rules.Reset();
+	CompiledConditions.Reset();
+
+	RulesGeneration++;
+}
+
+bool FUEDebuggerBreakpointConditions::Evaluate(const FUEDebuggerCachedNode* CachedNode, const UObject* ActiveObject, const FFrame& StackFrame, int32 CodeOffset)
+{
+	if (Rules.Num() == 0 || !CachedNode || !CachedNode->Node.IsValid())
+	{
+		return true;
+	}
+
+	const UFunction* Function = StackFrame.Node;
+	FCompiledCondition& Compiled = CompiledConditions.FindOrAdd(TPair<const UFunction*, int32>(Function, CodeOffset));
+	if (Compiled.Generation != RulesGeneration || Compiled.Function.Get() != Function)
+	{
+		Compiled.Generation = RulesGeneration;
+		Compiled.Function = Function;
+		Compiled.bHasCondition = false;
+		Compiled.bValid = false;
+
+		for (int32 RuleIndex = Rules.Num() - 1; RuleIndex >= 0; RuleIndex--)
+		{
+			const FRule& Rule = Rules[RuleIndex];
+			if (CachedNode->NodeTitleString.MatchesWildcard(Rule.NodeWildcard) || CachedNode->NodeCustomFullNameString.MatchesWildcard(Rule.NodeWildcard))
+			{
+				// Blueprint variables are members of the class owning the function, also valid for the instances of its child classes.
+				FString Error;
+				Compiled.bHasCondition = true;
+				const UEdGraphNode* Node = CachedNode->Node.Get();
+				Compiled.bValid = Compiled.Condition.Compile(Rule.Expression, Function, Function->GetOuterUClass(), Node, Node->GetTypedOuter<UBlueprint>(), Error);
+				if (!Compiled.bValid)
+				{
+					UE_LOG(LogUEDebuggerEditorModule, Warning, TEXT("UEDebugger.BreakpointCondition: %s: %s, the breakpoint is not printed."), *CachedNode->NodeCustomFullNameString, *Error);
+				}
+				break;
+			}
+		}
+	}
+
+	if (!Compiled.bHasCondition)
+	{
+		return true;
+	}
+
+	return Compiled.bValid && Compiled.Condition.Evaluate(ActiveObject, StackFrame);
+}
@@ -0,0 +1,134 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+struct FFrame;
+struct FUEDebuggerCachedNode;
+class UBlueprint;
+class UEdGraphNode;
+
+/**
+ * Predicate of a conditional PrintString breakpoint, compiled once into a small stack program.
+ * Identifiers are resolved, in this order, to:
+ *     the pins of the breakpoint node, by pin name or displayed name without spaces (e.g. "ReturnValue"), through FKismetDebugUtilities::FindClassPropertyForPin(),
+ *     so the compiler temporaries of the graph (e.g. "CallFunc_GetHealth_ReturnValue") are used with the name shown on the node;
+ *     the properties of the function of the hit (parameters and locals);
+ *     the properties of the class of the active object (Blueprint variables).
+ * "Self", "Owner" and "Instigator" are the active actor and its owner and instigator.
+ *
+ * Supported: numbers, "strings" (compared with names of objects, FName and FString), true/false, == != < <= > >=, && || !, parentheses.
+ * Example: Health < 10 && Owner == "BP_Enemy_3"
+ */
+class FUEDebuggerBreakpointCondition
+{
+public:
+
+	/**
+	 * @param Function	Function of the hit, its properties are read from the locals of the frame.
+	 * @param Class		Class of the object of the frame, its properties are read from the object.
+	 * @param Node		Node of the breakpoint, nullptr to only resolve variables.
+	 * @param Blueprint	Blueprint of Node, used to find the properties of its pins.
+	 * @param OutError	Set if the expression is invalid or an identifier is not found.
+	 */
+	bool Compile(const FString& Expression, const UFunction* Function, const UClass* Class, const UEdGraphNode* Node, UBlueprint* Blueprint, FString& OutError);
+
+	bool Evaluate(const UObject* ActiveObject, const FFrame& StackFrame) const;
+
+private:
+
+	enum class EOp : uint8
+	{
+		PushNumber,
+		PushName,
+		PushLocalProperty,
+		PushMemberProperty,
+		PushPinProperty,
+		PushSelf,
+		PushOwner,
+		PushInstigator,
+		Not,
+		And,
+		Or,
+		Equal,
+		NotEqual,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+	};
+
+	struct FInstruction
+	{
+		EOp Op;
+		double Number;
+		FName Name;
+		FString String;
+		const FProperty* Property;
+
+		/** PushPinProperty: Blueprint of the pin, to find the persistent frame of its ubergraph. */
+		const UBlueprint* Blueprint;
+	};
+
+	struct FParser;
+
+	TArray<FInstruction> Program;
+};
+
+/**
+ * Conditions of the breakpoints of "UEDebugger.BreakpointType 1", set with Console command
+ *     "UEDebugger.BreakpointCondition <NodeWildcard> <Expression>"
+ * NodeWildcard is matched against the title of the node and its print name, the last matching rule wins.
+ * "UEDebugger.BreakpointCondition <NodeWildcard>" removes the condition, "UEDebugger.BreakpointCondition Clear" removes all of them.
+ *
+ * Evaluated before the debug info is captured, so a failing condition costs a hash lookup and a few instructions.
+ */
+class FUEDebuggerBreakpointConditions
+{
+public:
+
+	static FUEDebuggerBreakpointConditions& Get();
+
+	/** @return true if the node has no condition or if its condition passes. */
+	bool Evaluate(const FUEDebuggerCachedNode* CachedNode, const UObject* ActiveObject, const FFrame& StackFrame, int32 CodeOffset);
+
+	void SetCondition(const FString& NodeWildcard, const FString& Expression);
+
+	void ClearConditions();
+
+private:
+
+	struct FRule
+	{
+		FString NodeWildcard;
+		FString Expression;
+	};
+
+	struct FCompiledCondition
+	{
+		/** RulesGeneration of the compiled condition. */
+		int32 Generation = INDEX_NONE;
+
+		/** The condition is compiled again if the function was replaced (recompiled Blueprint). */
+		TWeakObjectPtr<const UFunction> Function;
+
+		bool bHasCondition = false;
+
+		/** false if the expression did not compile, the hits are then never printed. */
+		bool bValid = false;
+
+		FUEDebuggerBreakpointCondition Condition;
+	};
+
+private:
+
+	TArray<FRule> Rules;
+
+	/** Increased when the rules change, so the conditions are compiled again. */
+	int32 RulesGeneration = 0;
+
+	/** [(Function, CodeOffset)] = Condition */
+	TMap<TPair<const UFunction*, int32>, FCompiledCondition> CompiledConditions;
+};
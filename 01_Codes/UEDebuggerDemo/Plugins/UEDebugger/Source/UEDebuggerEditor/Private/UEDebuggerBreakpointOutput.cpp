@@ -0,0 +1,114 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerBreakpointOutput.h"
+#include "UEDebuggerBPLibrary.h"
+#include "UEDebuggerPinValues.h"
+#include "Engine/World.h"
+#include "Misc/CoreDelegates.h"
+
+FUEDebuggerBreakpointOutput& FUEDebuggerBreakpointOutput::Get()
+{
+	static FUEDebuggerBreakpointOutput Singleton;
+	return Singleton;
+}
+
+void FUEDebuggerBreakpointOutput::Initialize()
+{
+	OnEndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FUEDebuggerBreakpointOutput::Flush);
+}
+
+void FUEDebuggerBreakpointOutput::Shutdown()
+{
+	FCoreDelegates::OnEndFrame.Remove(OnEndFrameHandle);
+	OnEndFrameHandle.Reset();
+
+	Buffers.Empty();
+}
+
+FUEDebuggerBreakpointOutput::FWorldBuffer& FUEDebuggerBreakpointOutput::FindOrAddBuffer(const UObject* ActiveObject)
+{
+	UWorld* World = ActiveObject->GetWorld();
+
+	FWorldBuffer* FreeBuffer = nullptr;
+	for (const TUniquePtr<FWorldBuffer>& Buffer : Buffers)
+	{
+		if (Buffer->NumHits == 0)
+		{
+			FreeBuffer = FreeBuffer ? FreeBuffer : Buffer.Get();
+		}
+		else if (Buffer->World.Get() == World)
+		{
+			return *Buffer;
+		}
+	}
+
+	if (!FreeBuffer)
+	{
+		FreeBuffer = Buffers.Add_GetRef(MakeUnique<FWorldBuffer>()).Get();
+	}
+
+	FreeBuffer->World = World;
+	FreeBuffer->WorldContextObject = const_cast<UObject*>(ActiveObject);
+	return *FreeBuffer;
+}
+
+void FUEDebuggerBreakpointOutput::AddHit(const UObject* ActiveObject, const FBlueprintExceptionDebugInfo& Info, bool bPrintToLog, float ScreenDuration)
+{
+	check(IsInGameThread());
+
+	// The values are shared with the flight recorder and the history of "UEDebugger.ExpandValue", which format them after the next garbage collection.
+	if (Info.PinValues.IsValid())
+	{
+		Info.PinValues->FreezeObjectReferences();
+	}
+
+	FWorldBuffer& Buffer = FindOrAddBuffer(ActiveObject);
+
+	if (Buffer.NumHits == 0)
+	{
+		Buffer.LogText.Appendf(TEXT("\n \n=================================================== FrameCounter: %llu ==================================================="), (uint64)GFrameCounter);
+		Buffer.ScreenText.Appendf(TEXT("======== FrameCounter: %llu ========"), (uint64)GFrameCounter);
+	}
+
+	if (bPrintToLog)
+	{
+		Buffer.LogText << TEXT("\n");
+		Info.AppendLogString(Buffer.LogText);
+		Buffer.NumLoggedHits++;
+	}
+
+	Buffer.ScreenText << TEXT("\n");
+	Info.AppendScreenString(Buffer.ScreenText);
+
+	Buffer.NumHits++;
+	Buffer.ScreenDuration = ScreenDuration;
+}
+
+void FUEDebuggerBreakpointOutput::Flush()
+{
+	static const FName BreakpointCategoryName(TEXT("Breakpoint"));
+
+	for (const TUniquePtr<FWorldBuffer>& Buffer : Buffers)
+	{
+		if (Buffer->NumHits == 0)
+		{
+			continue;
+		}
+
+		// The world context may be gone (e.g. destroyed by the last hit), the text is still written without the prefix of its world.
+		UObject* WorldContextObject = Buffer->WorldContextObject.Get();
+
+		if (Buffer->NumLoggedHits > 0)
+		{
+			UUEDebuggerBPLibrary::CustomPrintStringView(WorldContextObject, Buffer->LogText.ToView(), false, true, FLinearColor::Red, Buffer->ScreenDuration);
+		}
+		UUEDebuggerBPLibrary::CustomPrintStringView(WorldContextObject, Buffer->ScreenText.ToView(), true, false, FLinearColor::Red, Buffer->ScreenDuration, BreakpointCategoryName);
+
+		Buffer->LogText.Reset();
+		Buffer->ScreenText.Reset();
+		Buffer->NumHits = 0;
+		Buffer->NumLoggedHits = 0;
+		Buffer->World.Reset();
+		Buffer->WorldContextObject.Reset();
+	}
+}
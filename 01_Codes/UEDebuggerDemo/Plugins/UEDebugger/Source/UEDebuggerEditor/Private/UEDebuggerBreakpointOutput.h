@@ -0,0 +1,66 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/StringBuilder.h"
+#include "Templates/UniquePtr.h"
+#include "UObject/WeakObjectPtr.h"
+
+struct FBlueprintExceptionDebugInfo;
+
+/**
+ * Output of the breakpoints of "UEDebugger.BreakpointType 1".
+ * The hits of a frame are appended to a buffer per world, and flushed once at the end of the frame (FCoreDelegates::OnEndFrame):
+ * one log write, one viewport console update and one on-screen block per world, preceded by the header of the frame.
+ * The per-hit cost is the formatting of the hit into the buffer, the engine lookups of "CustomPrintString" happen once per frame.
+ */
+class FUEDebuggerBreakpointOutput
+{
+public:
+
+	static FUEDebuggerBreakpointOutput& Get();
+
+	/** Bind the end of frame flush, called by FUEDebuggerEditorModule. */
+	void Initialize();
+
+	void Shutdown();
+
+	/**
+	 * Game thread only.
+	 * @param bPrintToLog		false if the hit is only written to the screen (e.g. the binary trace replaces the log).
+	 * @param ScreenDuration	Duration of the on-screen block of this frame.
+	 */
+	void AddHit(const UObject* ActiveObject, const FBlueprintExceptionDebugInfo& Info, bool bPrintToLog, float ScreenDuration);
+
+	void Flush();
+
+private:
+
+	struct FWorldBuffer
+	{
+		TWeakObjectPtr<UWorld> World;
+
+		/** First active object of the frame in World, used as the world context of "CustomPrintString". */
+		TWeakObjectPtr<UObject> WorldContextObject;
+
+		TStringBuilder<8192> LogText;
+		TStringBuilder<2048> ScreenText;
+
+		int32 NumHits = 0;
+
+		/** Hits written to LogText, the log is skipped if none. */
+		int32 NumLoggedHits = 0;
+
+		float ScreenDuration = 0.0f;
+	};
+
+	FWorldBuffer& FindOrAddBuffer(const UObject* ActiveObject);
+
+private:
+
+	/** Reused from frame to frame, so the text buffers only grow during the first frames. */
+	TArray<TUniquePtr<FWorldBuffer>> Buffers;
+
+	FDelegateHandle OnEndFrameHandle;
+};
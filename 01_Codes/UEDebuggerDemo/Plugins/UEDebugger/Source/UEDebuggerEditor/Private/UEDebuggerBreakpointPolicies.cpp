@@ -0,0 +1,160 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerBreakpointPolicies.h"
+#include "UEDebuggerEditor.h"
+#include "UEDebuggerNodeCache.h"
+#include "EdGraph/EdGraphNode.h"
+
+static FAutoConsoleCommand CCmdBreakpointSampling(
+	TEXT("UEDebugger.BreakpointSampling"),
+	TEXT("Arguments: <NodeWildcard> <All|Nth|PerSecond|FirstPerFrame|First> [N] / Clear\n")
+	TEXT("Sampling of the breakpoints of \"UEDebugger.BreakpointType 1\" matching NodeWildcard (title or print name of the node, \"*\" for all nodes):\n")
+	TEXT(" All: print every hit. Nth: print every Nth hit. PerSecond: print at most N hits per second.\n")
+	TEXT(" FirstPerFrame: print the first hit of every frame. First: print the first N hits only.\n")
+	TEXT("Clear: remove all rules."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() == 1 && Args[0].Equals(TEXT("Clear"), ESearchCase::IgnoreCase))
+			{
+				FUEDebuggerBreakpointPolicies::Get().ClearRules();
+				UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("UEDebugger.BreakpointSampling: rules cleared"));
+				return;
+			}
+
+			if (Args.Num() < 2)
+			{
+				UE_LOG(LogUEDebuggerEditorModule, Warning, TEXT("Usage: UEDebugger.BreakpointSampling <NodeWildcard> <All|Nth|PerSecond|FirstPerFrame|First> [N] / Clear"));
+				return;
+			}
+
+			EUEDebuggerSamplingMode Mode;
+			if (Args[1].Equals(TEXT("All"), ESearchCase::IgnoreCase))
+			{
+				Mode = EUEDebuggerSamplingMode::All;
+			}
+			else if (Args[1].Equals(TEXT("Nth"), ESearchCase::IgnoreCase))
+			{
+				Mode = EUEDebuggerSamplingMode::EveryNth;
+			}
+			else if (Args[1].Equals(TEXT("PerSecond"), ESearchCase::IgnoreCase))
+			{
+				Mode = EUEDebuggerSamplingMode::PerSecond;
+			}
+			else if (Args[1].Equals(TEXT("FirstPerFrame"), ESearchCase::IgnoreCase))
+			{
+				Mode = EUEDebuggerSamplingMode::FirstPerFrame;
+			}
+			else if (Args[1].Equals(TEXT("First"), ESearchCase::IgnoreCase))
+			{
+				Mode = EUEDebuggerSamplingMode::FirstN;
+			}
+			else
+			{
+				UE_LOG(LogUEDebuggerEditorModule, Warning, TEXT("UEDebugger.BreakpointSampling: unknown mode %s"), *Args[1]);
+				return;
+			}
+
+			const int32 Value = Args.IsValidIndex(2) ? FMath::Max(1, FCString::Atoi(*Args[2])) : 1;
+			FUEDebuggerBreakpointPolicies::Get().AddRule(Args[0], Mode, Value);
+			UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("UEDebugger.BreakpointSampling: %s %s %d"), *Args[0], *Args[1], Value);
+		}));
+
+FUEDebuggerBreakpointPolicies& FUEDebuggerBreakpointPolicies::Get()
+{
+	static FUEDebuggerBreakpointPolicies Singleton;
+	return Singleton;
+}
+
+void FUEDebuggerBreakpointPolicies::AddRule(const FString& NodeWildcard, EUEDebuggerSamplingMode Mode, int32 Value)
+{
+	FRule& Rule = Rules.AddDefaulted_GetRef();
+	Rule.NodeWildcard = NodeWildcard;
+	Rule.Mode = Mode;
+	Rule.Value = Value;
+
+	RulesGeneration++;
+}
+
+void FUEDebuggerBreakpointPolicies::ClearRules()
+{
+	Rules.Reset();
+	NodeStates.Reset();
+
+	RulesGeneration++;
+}
+
+void FUEDebuggerBreakpointPolicies::ResolveRule(const FUEDebuggerCachedNode& CachedNode, FNodeState& State) const
+{
+	State.Generation = RulesGeneration;
+	State.Mode = EUEDebuggerSamplingMode::All;
+	State.Value = 0;
+
+	for (int32 RuleIndex = Rules.Num() - 1; RuleIndex >= 0; RuleIndex--)
+	{
+		const FRule& Rule = Rules[RuleIndex];
+		if (CachedNode.NodeTitleString.MatchesWildcard(Rule.NodeWildcard) || CachedNode.NodeCustomFullNameString.MatchesWildcard(Rule.NodeWildcard))
+		{
+			State.Mode = Rule.Mode;
+			State.Value = Rule.Value;
+			return;
+		}
+	}
+}
+
+bool FUEDebuggerBreakpointPolicies::ShouldPrint(const FUEDebuggerCachedNode* CachedNode, int64& OutSuppressedHits)
+{
+	OutSuppressedHits = 0;
+
+	const UEdGraphNode* Node = CachedNode ? CachedNode->Node.Get() : nullptr;
+	if (Rules.Num() == 0 || !Node)
+	{
+		return true;
+	}
+
+	FNodeState& State = NodeStates.FindOrAdd(Node->NodeGuid);
+	if (State.Generation != RulesGeneration)
+	{
+		ResolveRule(*CachedNode, State);
+	}
+
+	State.NumHits++;
+
+	bool bPrint = true;
+	switch (State.Mode)
+	{
+	case EUEDebuggerSamplingMode::All:
+		break;
+	case EUEDebuggerSamplingMode::EveryNth:
+		bPrint = (State.NumHits - 1) % State.Value == 0;
+		break;
+	case EUEDebuggerSamplingMode::PerSecond:
+		{
+			const double NowSeconds = FPlatformTime::Seconds();
+			if (NowSeconds - State.WindowStartSeconds >= 1.0)
+			{
+				State.WindowStartSeconds = NowSeconds;
+				State.NumPrintedInWindow = 0;
+			}
+			bPrint = State.NumPrintedInWindow < State.Value;
+			State.NumPrintedInWindow += bPrint ? 1 : 0;
+		}
+		break;
+	case EUEDebuggerSamplingMode::FirstPerFrame:
+		bPrint = State.LastPrintedFrame != GFrameCounter;
+		break;
+	case EUEDebuggerSamplingMode::FirstN:
+		bPrint = State.NumHits <= State.Value;
+		break;
+	}
+
+	if (!bPrint)
+	{
+		State.NumSuppressedHits++;
+		return false;
+	}
+
+	State.LastPrintedFrame = GFrameCounter;
+	OutSuppressedHits = State.NumSuppressedHits;
+	State.NumSuppressedHits = 0;
+	return true;
+}
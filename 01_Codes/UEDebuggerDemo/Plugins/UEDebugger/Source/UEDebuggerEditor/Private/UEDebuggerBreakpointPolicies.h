@@ -0,0 +1,90 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FUEDebuggerCachedNode;
+
+/**
+ * How often a PrintString breakpoint is printed.
+ */
+enum class EUEDebuggerSamplingMode : uint8
+{
+	/** Every hit. */
+	All,
+	/** Every Nth hit. */
+	EveryNth,
+	/** At most N hits per second. */
+	PerSecond,
+	/** The first hit of every frame. */
+	FirstPerFrame,
+	/** The first N hits only. */
+	FirstN,
+};
+
+/**
+ * Per-node sampling and rate limiting of the breakpoints of "UEDebugger.BreakpointType 1", set with Console command
+ *     "UEDebugger.BreakpointSampling <NodeWildcard> <All|Nth|PerSecond|FirstPerFrame|First> [N]"
+ * NodeWildcard is matched against the title of the node and its print name, e.g. "Print String(1234)", "*" for all nodes.
+ * The last matching rule wins. "UEDebugger.BreakpointSampling Clear" removes all rules.
+ *
+ * Suppressed hits only bump a counter of the node, which is shown in the next printed line.
+ * The state is kept per node (by NodeGuid), so it survives the recompilation of the Blueprint.
+ */
+class FUEDebuggerBreakpointPolicies
+{
+public:
+
+	static FUEDebuggerBreakpointPolicies& Get();
+
+	/**
+	 * Called for every hit, before the debug info is captured.
+	 * @param CachedNode		Node of the hit, nullptr if not found (always printed).
+	 * @param OutSuppressedHits	Number of hits suppressed since the last printed hit of this node.
+	 * @return Whether the hit should be printed.
+	 */
+	bool ShouldPrint(const FUEDebuggerCachedNode* CachedNode, int64& OutSuppressedHits);
+
+	void AddRule(const FString& NodeWildcard, EUEDebuggerSamplingMode Mode, int32 Value);
+
+	void ClearRules();
+
+private:
+
+	struct FRule
+	{
+		FString NodeWildcard;
+		EUEDebuggerSamplingMode Mode;
+		int32 Value;
+	};
+
+	struct FNodeState
+	{
+		/** RulesGeneration of the resolved Mode and Value. */
+		int32 Generation = INDEX_NONE;
+
+		EUEDebuggerSamplingMode Mode = EUEDebuggerSamplingMode::All;
+		int32 Value = 0;
+
+		int64 NumHits = 0;
+		int64 NumSuppressedHits = 0;
+
+		uint64 LastPrintedFrame = MAX_uint64;
+
+		double WindowStartSeconds = 0.0;
+		int32 NumPrintedInWindow = 0;
+	};
+
+	void ResolveRule(const FUEDebuggerCachedNode& CachedNode, FNodeState& State) const;
+
+private:
+
+	TArray<FRule> Rules;
+
+	/** Increased when the rules change, so the nodes resolve their rule again. */
+	int32 RulesGeneration = 0;
+
+	/** [NodeGuid] = State */
+	TMap<FGuid, FNodeState> NodeStates;
+};
@@ -2,21 +2,36 @@
 #include "UEDebuggerEditor.h"
 #include "Editor.h"
 #include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
 #include "KismetCompilerModule.h"
 #include "Kismet2/KismetDebugUtilities.h"
 #include "UEDebuggerBPLibrary.h"
+#include "UEDebuggerPinValues.h"
+#include "UEDebuggerScriptStacks.h"
 #include "WatchPointViewer.h"
+#include "UEDebuggerNodeCache.h"
+#include "UEDebuggerTrace.h"
+#include "UEDebuggerFlightRecorder.h"
+#include "UEDebuggerBreakpointPolicies.h"
+#include "UEDebuggerBreakpointConditions.h"
+#include "UEDebuggerProfiler.h"
+#include "UEDebuggerBreakpointOutput.h"
+#include "UEDebuggerInstances.h"
+#include "UEDebuggerWatchedPins.h"
+#include "UEDebuggerConsoleCommandGroup.h"
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
 
 #define LOCTEXT_NAMESPACE "FUEDebuggerEditorModule"
 
 DEFINE_LOG_CATEGORY(LogUEDebuggerEditorModule);
 
-static int64 GPreFrameCounter = 0;
 static float BreakpointScreenStringDuration = 10.0f;
 static FAutoConsoleCommandWithWorldAndArgs CVarBreakpointType(
 	TEXT("UEDebugger.BreakpointType"),
-	TEXT("Arguments: 0/1\n")
-	TEXT("0: Blueprint Breakpoint is default type. 1: Blueprint Breakpoint is used to PrintString."),
+	TEXT("Arguments: 0/1/2\n")
+	TEXT("0: Blueprint Breakpoint is default type. 1: Blueprint Breakpoint is used to PrintString.\n")
+	TEXT("2: Blueprint Breakpoint is used to profile the nodes, see \"UEDebugger.ProfileReport\"."),
 	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
 		{
 			BreakpointScreenStringDuration = 10.0f;
@@ -30,6 +45,12 @@ static FAutoConsoleCommandWithWorldAndArgs CVarBreakpointType(
 					/** Delegate that gets called when a script exception occurs */
 					FBlueprintCoreDelegates::OnScriptException.AddStatic(&FUEDebuggerEditorModule::OnScriptExceptionCustom);
 				}
+				else if (Value == 2)
+				{
+					FBlueprintCoreDelegates::OnScriptException.Clear();
+					/** Delegate that gets called when a script exception occurs */
+					FBlueprintCoreDelegates::OnScriptException.AddStatic(&FUEDebuggerProfiler::OnScriptException);
+				}
 				else
 				{
 					FBlueprintCoreDelegates::OnScriptException.Clear();
@@ -48,16 +69,61 @@ static FAutoConsoleCommandWithWorldAndArgs CVarBreakpointType(
 		}),
 	ECVF_Cheat);
 
+static TAutoConsoleVariable<int32> CVarBreakpointPrint(
+	TEXT("UEDebugger.BreakpointPrint"),
+	1,
+	TEXT("0: Breakpoints of \"UEDebugger.BreakpointType 1\" are only recorded by the flight recorder, see \"UEDebugger.DumpRecorder\".\n")
+	TEXT("1: Breakpoints of \"UEDebugger.BreakpointType 1\" are printed to the screen and to the log."),
+	ECVF_Default);
+
 
 void FUEDebuggerEditorModule::StartupModule()
 {
-
-
+	FUEDebuggerNodeCache::Get().Initialize();
+	FUEDebuggerFlightRecorder::Get().Initialize();
+	FUEDebuggerBreakpointOutput::Get().Initialize();
+	FUEDebuggerInstances::Get().Initialize();
+	FUEDebuggerWatchedPins::Get().Initialize();
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get())
+	{
+		DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(FPaths::ProjectConfigDir(),
+			IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FUEDebuggerEditorModule::OnProjectConfigDirectoryChanged),
+			ProjectConfigDirectoryChangedHandle);
+	}
 }
 
 void FUEDebuggerEditorModule::ShutdownModule()
 {
+	FUEDebuggerNodeCache::Get().Shutdown();
+	FUEDebuggerFlightRecorder::Get().Shutdown();
+	FUEDebuggerBreakpointOutput::Get().Shutdown();
+	FUEDebuggerInstances::Get().Shutdown();
+	FUEDebuggerWatchedPins::Get().Shutdown();
+	FUEDebuggerTraceWriter::Get().Stop();
+
+	if (FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+	{
+		if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+		{
+			DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(FPaths::ProjectConfigDir(), ProjectConfigDirectoryChangedHandle);
+		}
+	}
+	ProjectConfigDirectoryChangedHandle.Reset();
+}
 
+void FUEDebuggerEditorModule::OnProjectConfigDirectoryChanged(const TArray<FFileChangeData>& FileChanges)
+{
+	for (const FFileChangeData& FileChange : FileChanges)
+	{
+		if (FPaths::GetCleanFilename(FileChange.Filename).EndsWith(TEXT("Game.ini")))
+		{
+			UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("%s changed, reloading the ConsoleCommandGroups"), *FileChange.Filename);
+			IConsoleCommandGroupManager::Get().ReloadConfigConsoleCommandGroups();
+			return;
+		}
+	}
 }
 
 
@@ -73,6 +139,33 @@ void FUEDebuggerEditorModule::OnScriptExceptionCustom(const UObject* ActiveObjec
 		return;
 	}
 
+	// The hits of the PIE instances excluded by "UEDebugger.BreakpointFilter" are not even recorded.
+	if (!FUEDebuggerInstances::Get().PassesFilter(ActiveObject))
+	{
+		return;
+	}
+
+	const int64 RecordIndex = FUEDebuggerFlightRecorder::Get().Record(ActiveObject, StackFrame);
+
+	if (CVarBreakpointPrint.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+	// Condition and sampling of the node, before any capture work.
+	const int32 BreakpointOffset = StackFrame.Code - StackFrame.Node->Script.GetData() - 1;
+	const FUEDebuggerCachedNode* CachedNode = FUEDebuggerNodeCache::Get().FindOrResolve(ActiveObject, StackFrame.Node, BreakpointOffset);
+	if (!FUEDebuggerBreakpointConditions::Get().Evaluate(CachedNode, ActiveObject, StackFrame, BreakpointOffset))
+	{
+		return;
+	}
+
+	int64 SuppressedHits = 0;
+	if (!FUEDebuggerBreakpointPolicies::Get().ShouldPrint(CachedNode, SuppressedHits))
+	{
+		return;
+	}
+
 	FBlueprintExceptionDebugInfo BlueprintExceptionDebugInfo;
 	bool ValidDebugInfo = FUEDebuggerEditorModule::GetBlueprintExceptionDebugInfo(ActiveObject, StackFrame, Info, BlueprintExceptionDebugInfo);
 
@@ -81,22 +174,81 @@ void FUEDebuggerEditorModule::OnScriptExceptionCustom(const UObject* ActiveObjec
 		return;
 	}
 
-	FString LogString = BlueprintExceptionDebugInfo.ToLogString();
-	FString ScreenString = BlueprintExceptionDebugInfo.ToScreenString();
+	// The dump of the recorder shows the values of the printed hits.
+	FUEDebuggerFlightRecorder::Get().AttachPinValues(RecordIndex, BlueprintExceptionDebugInfo.PinValues);
 
-	UObject* ActiveObjectTemp = const_cast<UObject*>(ActiveObject);
+	BlueprintExceptionDebugInfo.SuppressedHits = SuppressedHits;
 
-	if (GPreFrameCounter != GFrameCounter)
+	// The trace replaces the text in the log.
+	const bool bTrace = FUEDebuggerTraceWriter::Get().IsActive();
+	if (bTrace)
 	{
-		FString FrameCounterInfoForLog = FString::Printf(TEXT("\n \n=================================================== FrameCounter: %d ==================================================="), GFrameCounter);
-		UUEDebuggerBPLibrary::CustomPrintString(ActiveObjectTemp, FrameCounterInfoForLog, false, true, FLinearColor::Yellow, BreakpointScreenStringDuration);
-		FString FrameCounterInfoForScreen = FString::Printf(TEXT("======== FrameCounter: %d ========"), GFrameCounter);
-		UUEDebuggerBPLibrary::CustomPrintString(ActiveObjectTemp, FrameCounterInfoForScreen, true, false, FLinearColor::Yellow, BreakpointScreenStringDuration);
+		FUEDebuggerTraceWriter::Get().WriteHit(BlueprintExceptionDebugInfo);
+	}
+
+	// Written at the end of the frame, with the other hits of the frame.
+	FUEDebuggerBreakpointOutput::Get().AddHit(ActiveObject, BlueprintExceptionDebugInfo, !bTrace, BreakpointScreenStringDuration);
+}
+
+void* FUEDebuggerEditorModule::FindPinPropertyContainer(const UBlueprint* Blueprint, UObject* BlueprintInstance, const FProperty* Property)
+{
+	if (!BlueprintInstance || !Property)
+	{
+		return nullptr;
+	}
+
+	void* PropertyBase = nullptr;
+
+	const TArray<const FFrame*>& ScriptStack = FBlueprintContextTracker::Get().GetScriptStack();
+	for (int32 FrameIndex = ScriptStack.Num() - 1; FrameIndex >= 0; FrameIndex--)
+	{
+		const FFrame* Frame = ScriptStack[FrameIndex];
+		if (Frame && Property->IsIn(Frame->Node))
+		{
+			PropertyBase = Frame->Locals;
+			break;
+		}
+	}
+
+	UClass* PropertyClass = Property->GetOwner<UClass>();
+	if (!PropertyBase && PropertyClass && BlueprintInstance->GetClass()->IsChildOf(PropertyClass))
+	{
+		PropertyBase = BlueprintInstance;
+	}
+
+#if USE_UBER_GRAPH_PERSISTENT_FRAME
+	UBlueprintGeneratedClass* GeneratedClass = Blueprint ? Cast<UBlueprintGeneratedClass>(Blueprint->GeneratedClass) : nullptr;
+	if (!PropertyBase && GeneratedClass && GeneratedClass->UberGraphFramePointerProperty && GeneratedClass->UberGraphFunction && Property->IsIn(GeneratedClass->UberGraphFunction)
+		&& BlueprintInstance->GetClass()->IsChildOf(GeneratedClass))
+	{
+		FPointerToUberGraphFrame* PointerToUberGraphFrame = GeneratedClass->UberGraphFramePointerProperty->ContainerPtrToValuePtr<FPointerToUberGraphFrame>(BlueprintInstance);
+		PropertyBase = PointerToUberGraphFrame ? PointerToUberGraphFrame->RawPointer : nullptr;
+	}
+#endif
+
+	return PropertyBase;
+}
+
+/** Copies the value of Property, the property of Pin. */
+static void CapturePinValue(FUEDebuggerPinValues& PinValues, EUEDebuggerPinKind Kind, UBlueprint* Blueprint, UObject* BlueprintInstance, const UEdGraphPin* Pin, const FProperty* Property)
+{
+	if (!Pin)
+	{
+		return;
+	}
+
+	if (void* PropertyBase = FUEDebuggerEditorModule::FindPinPropertyContainer(Blueprint, BlueprintInstance, Property))
+	{
+		PinValues.Capture(Kind, Pin->PinName, Property, Property->ContainerPtrToValuePtr<void>(PropertyBase));
+	}
+}
+
+static void CapturePinValue(FUEDebuggerPinValues& PinValues, EUEDebuggerPinKind Kind, UBlueprint* Blueprint, UObject* BlueprintInstance, const UEdGraphPin* Pin)
+{
+	if (Pin && BlueprintInstance)
+	{
+		CapturePinValue(PinValues, Kind, Blueprint, BlueprintInstance, Pin, FKismetDebugUtilities::FindClassPropertyForPin(Blueprint, Pin));
 	}
-	GPreFrameCounter = GFrameCounter;
-	
-	UUEDebuggerBPLibrary::CustomPrintString(ActiveObjectTemp, LogString, false, true, FLinearColor::Red, BreakpointScreenStringDuration);
-	UUEDebuggerBPLibrary::CustomPrintString(ActiveObjectTemp, ScreenString, true, false, FLinearColor::Red, BreakpointScreenStringDuration);
 }
 
 bool FUEDebuggerEditorModule::GetBlueprintExceptionDebugInfo(const UObject* ActiveObject, const FFrame& StackFrame, const FBlueprintExceptionInfo& Info, FBlueprintExceptionDebugInfo& OutBlueprintExceptionDebugInfo)
@@ -111,19 +263,17 @@ bool FUEDebuggerEditorModule::GetBlueprintExceptionDebugInfo(const UObject* Acti
 	int64 FrameCounter = (int64)GFrameCounter;
 	FString FrameCounterString = FString::Printf(TEXT("%d"), FrameCounter);
 
-	static int64 Index = 0;
-	FString IndexString = FString::Printf(TEXT("%d"), Index);
-	Index++;
+	// Numbered per PIE instance, so the hits of a server and of its clients do not interleave.
+	FUEDebuggerInstance& Instance = FUEDebuggerInstances::Get().FindOrAdd(ActiveObject);
+	const int64 Index = Instance.NextHitIndex.fetch_add(1, std::memory_order_relaxed);
+	FString IndexString = FString::Printf(TEXT("%lld"), Index);
 
 	FString TimestampString = FPlatformTime::StrTimestamp();
 
 	FString ActiveObjectNameString = ActiveObject->GetName();
 
-	FString StackTraceString = StackFrame.GetStackTrace();
-	FString ScriptCallstackString = StackFrame.GetScriptCallstack();
-	FString StackDescriptionString = StackFrame.GetStackDescription();
-
-	FString PreFrameNameString;
+	// The stack strings are rendered once per unique stack, a hit only keeps the id of its stack.
+	const uint32 StackId = FUEDebuggerScriptStacks::Get().Intern(StackFrame);
 
 	FString NodeGraphNameString;
 
@@ -132,10 +282,7 @@ bool FUEDebuggerEditorModule::GetBlueprintExceptionDebugInfo(const UObject* Acti
 	FString NodeUniqueIDString;
 	FString NodeCustomFullNameString; // Use this for Print.
 
-	TArray<FString> WatchedPinsStrings;
-
-	TArray<FString> InputParametersStrings;
-	TArray<FString> OutputParametersStrings;
+	TSharedPtr<FUEDebuggerPinValues> PinValues;
 
 	FString OwnerNameString;
 	FString InstigatorNameString;
@@ -146,88 +293,50 @@ bool FUEDebuggerEditorModule::GetBlueprintExceptionDebugInfo(const UObject* Acti
 	// FKismetDebugUtilitiesData& Data = FKismetDebugUtilitiesData::Get();
 	const int32 BreakpointOffset = StackFrame.Code - StackFrame.Node->Script.GetData() - 1;
 
-	const TArray<const FFrame*>& ScriptStack = FBlueprintContextTracker::Get().GetScriptStack();
-
-	if (ScriptStack.IsValidIndex(0))
-	{
-		const FFrame* PreFrame = ScriptStack[0];
-		if (PreFrame)
-		{
-			PreFrameNameString = PreFrame->GetStackDescription();
-		}
-	}
-
 	UObject* BlueprintInstance = StackFrame.Object;
 	UClass* Class = BlueprintInstance ? BlueprintInstance->GetClass() : nullptr;
 	UBlueprint* BlueprintObj = (Class ? Cast<UBlueprint>(Class->ClassGeneratedBy) : nullptr);
 
 
-	// Find the node that generated the code which we hit
-	UEdGraphNode* NodeStoppedAt = FKismetDebugUtilities::FindSourceNodeForCodeLocation(ActiveObject, StackFrame.Node, BreakpointOffset, /*bAllowImpreciseHit=*/ true);
+	// Find the node that generated the code which we hit, resolved once per (Function, Offset)
+	const FUEDebuggerCachedNode* CachedNode = FUEDebuggerNodeCache::Get().FindOrResolve(ActiveObject, StackFrame.Node, BreakpointOffset);
+	UEdGraphNode* NodeStoppedAt = CachedNode ? CachedNode->Node.Get() : nullptr;
 
 	if (NodeStoppedAt)
 	{
-		if (NodeStoppedAt->GetGraph())
-		{
-			NodeGraphNameString = NodeStoppedAt->GetGraph()->GetName();
-		}
-		
-		NodeNameString = NodeStoppedAt->GetDescriptiveCompiledName();
-		NodeTitleString = NodeStoppedAt->GetNodeTitle(ENodeTitleType::ListView).ToString();
-		NodeUniqueIDString = FString::Printf(TEXT("%d"), NodeStoppedAt->GetUniqueID());
+		NodeGraphNameString = CachedNode->NodeGraphNameString;
 
-		NodeCustomFullNameString = NodeTitleString + TEXT("(") + NodeUniqueIDString + TEXT(")");
+		NodeNameString = CachedNode->NodeNameString;
+		NodeTitleString = CachedNode->NodeTitleString;
+		NodeUniqueIDString = CachedNode->NodeUniqueIDString;
 
-		if(BlueprintObj)
+		NodeCustomFullNameString = CachedNode->NodeCustomFullNameString;
+
+		if (BlueprintObj)
 		{
-			// WatchViewer::UpdateInstancedWatchDisplay();
+			// Only the raw values are captured here, converted to text when a sink formats them.
+			PinValues = MakeShared<FUEDebuggerPinValues>();
 
-			// We have a valid instance, iterate over all the watched pins and create rows for them
-			for (const FEdGraphPinReference& PinRef : BlueprintObj->WatchedPins)
+			// We have a valid instance, capture the watched pins relevant to the node, see "UEDebugger.WatchedPinsScope"
+			for (const FUEDebuggerWatchedPin& WatchedPin : FUEDebuggerWatchedPins::Get().Find(BlueprintObj, NodeStoppedAt))
 			{
-				UEdGraphPin* Pin = PinRef.Get();
-
-				// FText GraphName = FText::FromString(Pin->GetOwningNode()->GetGraph()->GetName());
-				// FText NodeName = Pin->GetOwningNode()->GetNodeTitle(ENodeTitleType::ListView);
-
-				FDebugInfo DebugInfo;
-				const FKismetDebugUtilities::EWatchTextResult WatchStatus = FKismetDebugUtilities::GetDebugInfo(DebugInfo, BlueprintObj, BlueprintInstance, Pin);
-
-				if (WatchStatus == FKismetDebugUtilities::EWTR_Valid)
-				{
-					// DebugInfo.Type
-					FString PinInfoString = TEXT("\"") + DebugInfo.DisplayName.ToString() + TEXT("\" = \"") + DebugInfo.Value.ToString() + TEXT("\"");
-					WatchedPinsStrings.Add(PinInfoString);
-				}
+				CapturePinValue(*PinValues, EUEDebuggerPinKind::Watched, BlueprintObj, BlueprintInstance, WatchedPin.PinReference.Get(), WatchedPin.Property);
 			}
-		}
-
-		const TArray<UEdGraphPin*>& Pins = NodeStoppedAt->GetAllPins();
 
-		for (UEdGraphPin* Pin : Pins)
-		{
-			if (!Pin)
+			for (const UEdGraphPin* Pin : NodeStoppedAt->GetAllPins())
 			{
-				continue;
-			}
-
-			// FText GraphName = FText::FromString(Pin->GetOwningNode()->GetGraph()->GetName());
-			// FText NodeName = Pin->GetOwningNode()->GetNodeTitle(ENodeTitleType::ListView);
-
-			FDebugInfo DebugInfo;
-			const FKismetDebugUtilities::EWatchTextResult WatchStatus = FKismetDebugUtilities::GetDebugInfo(DebugInfo, BlueprintObj, BlueprintInstance, Pin);
+				if (!Pin)
+				{
+					continue;
+				}
 
-			if (WatchStatus == FKismetDebugUtilities::EWTR_Valid)
-			{
-				// DebugInfo.Type
-				FString PinInfoString = TEXT("\"") + DebugInfo.DisplayName.ToString() + TEXT("\" = \"") + DebugInfo.Value.ToString() + TEXT("\"");
 				if (Pin->Direction == EEdGraphPinDirection::EGPD_Input)
 				{
-					InputParametersStrings.Add(PinInfoString);
+					CapturePinValue(*PinValues, EUEDebuggerPinKind::Input, BlueprintObj, BlueprintInstance, Pin);
 				}
 				else if (Pin->Direction == EEdGraphPinDirection::EGPD_Output)
 				{
-					OutputParametersStrings.Add(PinInfoString);
+					CapturePinValue(*PinValues, EUEDebuggerPinKind::Output, BlueprintObj, BlueprintInstance, Pin);
 				}
 			}
 		}
@@ -264,11 +373,7 @@ bool FUEDebuggerEditorModule::GetBlueprintExceptionDebugInfo(const UObject* Acti
 
 		OutBlueprintExceptionDebugInfo.ActiveObjectNameString = ActiveObjectNameString;
 
-		OutBlueprintExceptionDebugInfo.StackTraceString = StackTraceString;
-		OutBlueprintExceptionDebugInfo.ScriptCallstackString = ScriptCallstackString;
-		OutBlueprintExceptionDebugInfo.StackDescriptionString = StackDescriptionString;
-
-		OutBlueprintExceptionDebugInfo.PreFrameNameString = PreFrameNameString;
+		OutBlueprintExceptionDebugInfo.StackId = StackId;
 
 		OutBlueprintExceptionDebugInfo.NodeGraphNameString = NodeGraphNameString;
 
@@ -277,11 +382,8 @@ bool FUEDebuggerEditorModule::GetBlueprintExceptionDebugInfo(const UObject* Acti
 		OutBlueprintExceptionDebugInfo.NodeUniqueIDString = NodeUniqueIDString;
 		OutBlueprintExceptionDebugInfo.NodeCustomFullNameString = NodeCustomFullNameString;
 
-		OutBlueprintExceptionDebugInfo.WatchedPinsStrings = WatchedPinsStrings;
-
-		OutBlueprintExceptionDebugInfo.InputParametersStrings = InputParametersStrings;
-
-		OutBlueprintExceptionDebugInfo.OutputParametersStrings = OutputParametersStrings;
+		OutBlueprintExceptionDebugInfo.PinValues = PinValues;
+		FUEDebuggerPinValueHistory::Get().Add(Instance.Name, Index, PinValues);
 
 		OutBlueprintExceptionDebugInfo.OwnerNameString = OwnerNameString;
 		OutBlueprintExceptionDebugInfo.InstigatorNameString = InstigatorNameString;
@@ -0,0 +1,186 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerFlightRecorder.h"
+#include "UEDebuggerEditor.h"
+#include "UEDebuggerNodeCache.h"
+#include "UEDebuggerPinValues.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "UObject/Script.h"
+#include "UObject/Stack.h"
+
+static TAutoConsoleVariable<int32> CVarFlightRecorderSize(
+	TEXT("UEDebugger.FlightRecorder.Size"),
+	4096,
+	TEXT("Number of recent breakpoint hits kept by the flight recorder, 0 to disable it. Read once at editor startup, set it in an ini file."),
+	ECVF_Default);
+
+static FAutoConsoleCommand CCmdDumpRecorder(
+	TEXT("UEDebugger.DumpRecorder"),
+	TEXT("Arguments: [N] [Filename]\n")
+	TEXT("Writes the N most recent breakpoint hits of the flight recorder to the log (all by default), and to Filename if specified."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 NumRecords = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 0;
+			FUEDebuggerFlightRecorder::Get().Dump(NumRecords, Args.IsValidIndex(1) ? Args[1] : FString(), true);
+		}));
+
+FUEDebuggerFlightRecorder& FUEDebuggerFlightRecorder::Get()
+{
+	static FUEDebuggerFlightRecorder Singleton;
+	return Singleton;
+}
+
+FUEDebuggerFlightRecorder::FUEDebuggerFlightRecorder()
+	: WriteIndex(0)
+{
+	Records.SetNumZeroed(FMath::Max(0, CVarFlightRecorderSize.GetValueOnGameThread()));
+}
+
+void FUEDebuggerFlightRecorder::Initialize()
+{
+	OnHandleSystemErrorHandle = FCoreDelegates::OnHandleSystemError.AddRaw(this, &FUEDebuggerFlightRecorder::OnHandleSystemError);
+	OnEndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FUEDebuggerFlightRecorder::ReleaseOverwrittenPinValues);
+}
+
+void FUEDebuggerFlightRecorder::Shutdown()
+{
+	FCoreDelegates::OnHandleSystemError.Remove(OnHandleSystemErrorHandle);
+	OnHandleSystemErrorHandle.Reset();
+	FCoreDelegates::OnEndFrame.Remove(OnEndFrameHandle);
+	OnEndFrameHandle.Reset();
+
+	ReleaseOverwrittenPinValues();
+}
+
+void FUEDebuggerFlightRecorder::OnHandleSystemError()
+{
+	// Node resolution is not safe while crashing.
+	Dump(0, FString(), false);
+}
+
+void FUEDebuggerFlightRecorder::ReleaseOverwrittenPinValues()
+{
+	// The capacity is kept for the next frame.
+	OverwrittenPinValues.Reset();
+}
+
+int64 FUEDebuggerFlightRecorder::Record(const UObject* ActiveObject, const FFrame& StackFrame)
+{
+	if (Records.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const uint64 Index = WriteIndex.fetch_add(1, std::memory_order_relaxed);
+
+	FUEDebuggerFlightRecord& Record = Records[int32(Index % uint64(Records.Num()))];
+	Record.Cycles = FPlatformTime::Cycles64();
+	Record.FrameCounter = (int64)GFrameCounter;
+	Record.Index = (int64)Index;
+	Record.ActiveObject = ActiveObject;
+	Record.Function = StackFrame.Node;
+	Record.CodeOffset = StackFrame.Code - StackFrame.Node->Script.GetData() - 1;
+
+	const TArray<const FFrame*>& ScriptStack = FBlueprintContextTracker::Get().GetScriptStack();
+	const FFrame* CallerFrame = ScriptStack.Num() > 1 ? ScriptStack[ScriptStack.Num() - 2] : nullptr;
+	Record.CallerFunction = CallerFrame ? CallerFrame->Node : nullptr;
+	Record.CallerCodeOffset = CallerFrame ? int32(CallerFrame->Code - CallerFrame->Node->Script.GetData() - 1) : INDEX_NONE;
+
+	// Moved out rather than freed here, a record is a cheap write into the ring.
+	if (Record.PinValues.IsValid())
+	{
+		OverwrittenPinValues.Add(MoveTemp(Record.PinValues));
+	}
+
+	return Record.Index;
+}
+
+void FUEDebuggerFlightRecorder::AttachPinValues(int64 RecordIndex, const TSharedPtr<FUEDebuggerPinValues>& PinValues)
+{
+	if (RecordIndex < 0 || Records.Num() == 0)
+	{
+		return;
+	}
+
+	FUEDebuggerFlightRecord& Record = Records[int32(uint64(RecordIndex) % uint64(Records.Num()))];
+	if (Record.Index == RecordIndex)
+	{
+		Record.PinValues = PinValues;
+	}
+}
+
+void FUEDebuggerFlightRecorder::Dump(int32 NumRecords, const FString& Filename, bool bResolveNodes)
+{
+	const uint64 NumRecorded = WriteIndex.load(std::memory_order_relaxed);
+	const uint64 NumAvailable = FMath::Min<uint64>(NumRecorded, uint64(Records.Num()));
+	const uint64 NumToDump = NumRecords > 0 ? FMath::Min<uint64>(NumAvailable, uint64(NumRecords)) : NumAvailable;
+
+	const uint64 NowCycles = FPlatformTime::Cycles64();
+
+	FString FileContent;
+
+	UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("=================== UEDebugger FlightRecorder: %llu of %llu hits ==================="), NumToDump, NumRecorded);
+
+	for (uint64 RecordIndex = NumRecorded - NumToDump; RecordIndex < NumRecorded; RecordIndex++)
+	{
+		const FUEDebuggerFlightRecord& Record = Records[int32(RecordIndex % uint64(Records.Num()))];
+
+		const UObject* ActiveObject = Record.ActiveObject.Get();
+		UFunction* Function = Record.Function.Get();
+		UFunction* CallerFunction = Record.CallerFunction.Get();
+
+		FString NodeString;
+		if (bResolveNodes && ActiveObject && Function)
+		{
+			if (const FUEDebuggerCachedNode* CachedNode = FUEDebuggerNodeCache::Get().FindOrResolve(ActiveObject, Function, Record.CodeOffset))
+			{
+				NodeString = FString::Printf(TEXT(" %s.\"%s\""), *CachedNode->NodeGraphNameString, *CachedNode->NodeCustomFullNameString);
+			}
+		}
+
+		const FString Line = FString::Printf(TEXT("[%lld(%lld)] -%.3fms %s%s (%s+%d) <- (%s+%d)"),
+			Record.FrameCounter,
+			Record.Index,
+			FPlatformTime::ToMilliseconds64(NowCycles - Record.Cycles),
+			*GetNameSafe(ActiveObject),
+			*NodeString,
+			*GetNameSafe(Function),
+			Record.CodeOffset,
+			*GetNameSafe(CallerFunction),
+			Record.CallerCodeOffset);
+
+		UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("%s"), *Line);
+
+		if (!Filename.IsEmpty())
+		{
+			FileContent += Line;
+			FileContent += LINE_TERMINATOR;
+		}
+
+		// The values are not converted while crashing, like the nodes.
+		if (bResolveNodes && Record.PinValues.IsValid())
+		{
+			const FUEDebuggerPinValues& PinValues = *Record.PinValues;
+			for (int32 PinIndex = 0; PinIndex < PinValues.Num(); PinIndex++)
+			{
+				TStringBuilder<256> PinString;
+				PinString << TEXT("\t");
+				PinValues.AppendPinString(PinString, PinIndex);
+
+				UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("%s"), PinString.ToString());
+
+				if (!Filename.IsEmpty())
+				{
+					FileContent += PinString.ToString();
+					FileContent += LINE_TERMINATOR;
+				}
+			}
+		}
+	}
+
+	if (!Filename.IsEmpty())
+	{
+		FFileHelper::SaveStringToFile(FileContent, *Filename);
+	}
+}
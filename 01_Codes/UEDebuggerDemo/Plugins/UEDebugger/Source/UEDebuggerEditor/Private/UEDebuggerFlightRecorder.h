@@ -0,0 +1,96 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include <atomic>
+
+struct FFrame;
+class FUEDebuggerPinValues;
+
+/**
+ * Raw breakpoint hit, nothing is formatted until the record is dumped.
+ */
+struct FUEDebuggerFlightRecord
+{
+	uint64 Cycles;
+
+	int64 FrameCounter;
+
+	int64 Index;
+
+	TWeakObjectPtr<const UObject> ActiveObject;
+
+	TWeakObjectPtr<UFunction> Function;
+
+	int32 CodeOffset;
+
+	/** Previous frame of the script stack, if any. */
+	TWeakObjectPtr<UFunction> CallerFunction;
+
+	/** Same convention as CodeOffset: the offset of the instruction being run, not of the next one. */
+	int32 CallerCodeOffset;
+
+	/**
+	 * Raw pin values of the hit, shared with the breakpoint output. Only set for the hits which were printed, as capturing
+	 * them for every hit would cost more than the record itself: null with "UEDebugger.BreakpointPrint 0", or when the hit was
+	 * rejected by its condition or its sampling.
+	 */
+	TSharedPtr<FUEDebuggerPinValues> PinValues;
+};
+
+/**
+ * Fixed-size, preallocated ring of the recent breakpoint hits of "UEDebugger.BreakpointType 1".
+ * Always on: recording a hit is a copy of a FUEDebuggerFlightRecord into the ring, formatting only happens when dumped,
+ * with Console command "UEDebugger.DumpRecorder [N] [Filename]" or automatically on a crash.
+ * Use "UEDebugger.BreakpointPrint 0" to only record the hits, without screen and log output.
+ */
+class FUEDebuggerFlightRecorder
+{
+public:
+
+	static FUEDebuggerFlightRecorder& Get();
+
+	/** Bind the crash handler and the end of frame, called by FUEDebuggerEditorModule. */
+	void Initialize();
+
+	void Shutdown();
+
+	/** @return The index of the record, to attach its pin values, INDEX_NONE if the recorder is disabled. */
+	int64 Record(const UObject* ActiveObject, const FFrame& StackFrame);
+
+	/** Attach the pin values captured for the printed hit of the record RecordIndex, if it was not overwritten since. */
+	void AttachPinValues(int64 RecordIndex, const TSharedPtr<FUEDebuggerPinValues>& PinValues);
+
+	/**
+	 * Writes the most recent hits to the log, oldest first.
+	 * @param NumRecords	0 for all the recorded hits.
+	 * @param Filename		Also written to this file if not empty.
+	 * @param bResolveNodes	false when crashing, only the names of the functions are written.
+	 */
+	void Dump(int32 NumRecords, const FString& Filename, bool bResolveNodes);
+
+private:
+
+	FUEDebuggerFlightRecorder();
+
+	void OnHandleSystemError();
+
+	/** Frees the pin values of the records overwritten during the frame, at the end of the frame. */
+	void ReleaseOverwrittenPinValues();
+
+private:
+
+	TArray<FUEDebuggerFlightRecord> Records;
+
+	/** Number of recorded hits since the start, the next record is written at WriteIndex % Records.Num(). */
+	std::atomic<uint64> WriteIndex;
+
+	/** Pin values of the overwritten records, a deep copy can be large and is not freed on the breakpoint path. */
+	TArray<TSharedPtr<FUEDebuggerPinValues>> OverwrittenPinValues;
+
+	FDelegateHandle OnHandleSystemErrorHandle;
+
+	FDelegateHandle OnEndFrameHandle;
+};
@@ -0,0 +1,153 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerInstances.h"
+#include "UEDebuggerEditor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+static FAutoConsoleCommand CCmdBreakpointFilter(
+	TEXT("UEDebugger.BreakpointFilter"),
+	TEXT("Arguments: [Server|Client1|Client2|...]\n")
+	TEXT("Only the breakpoints of \"UEDebugger.BreakpointType 1\" hit in the matching PIE instances are recorded and printed, wildcards are supported (e.g. \"Client*\").\n")
+	TEXT("No argument, \"*\" or \"All\": all instances."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			FUEDebuggerInstances::Get().SetFilter(FString::Join(Args, TEXT(" ")));
+
+			const FString& Filter = FUEDebuggerInstances::Get().GetFilter();
+			UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("UEDebugger.BreakpointFilter is %s"), Filter.IsEmpty() ? TEXT("All") : *Filter);
+		}));
+
+FUEDebuggerInstances& FUEDebuggerInstances::Get()
+{
+	static FUEDebuggerInstances Singleton;
+	return Singleton;
+}
+
+void FUEDebuggerInstances::Initialize()
+{
+	OnWorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddRaw(this, &FUEDebuggerInstances::OnWorldCleanup);
+}
+
+void FUEDebuggerInstances::Shutdown()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(OnWorldCleanupHandle);
+	OnWorldCleanupHandle.Reset();
+
+	Instances.Empty();
+	LastWorld = nullptr;
+	LastInstance = nullptr;
+}
+
+void FUEDebuggerInstances::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	Instances.Remove(World);
+
+	if (LastWorld == World)
+	{
+		LastWorld = nullptr;
+		LastInstance = nullptr;
+	}
+}
+
+FName FUEDebuggerInstances::GetInstanceName(UWorld* World, int32& OutPIEInstance)
+{
+	OutPIEInstance = INDEX_NONE;
+
+	if (!World)
+	{
+		return FName(TEXT("Global"));
+	}
+
+	if (World->WorldType == EWorldType::PIE)
+	{
+		const FWorldContext* WorldContext = GEngine ? GEngine->GetWorldContextFromWorld(World) : nullptr;
+		OutPIEInstance = WorldContext ? WorldContext->PIEInstance : GPlayInEditorID;
+
+		switch (World->GetNetMode())
+		{
+		case NM_Client:
+			return FName(*FString::Printf(TEXT("Client%d"), OutPIEInstance));
+		case NM_DedicatedServer:
+		case NM_ListenServer:
+			return FName(TEXT("Server"));
+		default:
+			return FName(TEXT("Standalone"));
+		}
+	}
+
+	return World->WorldType == EWorldType::Editor ? FName(TEXT("Editor")) : FName(TEXT("Standalone"));
+}
+
+FUEDebuggerInstance& FUEDebuggerInstances::FindOrAdd(const UObject* ActiveObject)
+{
+	check(IsInGameThread());
+
+	UWorld* World = ActiveObject ? ActiveObject->GetWorld() : nullptr;
+	if (LastInstance && LastWorld == World)
+	{
+		return *LastInstance;
+	}
+
+	TUniquePtr<FUEDebuggerInstance>& Instance = Instances.FindOrAdd(World);
+	if (!Instance.IsValid())
+	{
+		Instance = MakeUnique<FUEDebuggerInstance>();
+		Instance->Name = GetInstanceName(World, Instance->PIEInstance);
+	}
+
+	LastWorld = World;
+	LastInstance = Instance.Get();
+	return *Instance;
+}
+
+bool FUEDebuggerInstances::PassesFilter(const UObject* ActiveObject)
+{
+	if (FilterPatterns.Num() == 0)
+	{
+		return true;
+	}
+
+	FUEDebuggerInstance& Instance = FindOrAdd(ActiveObject);
+	if (Instance.FilterGeneration != FilterGeneration)
+	{
+		const FString InstanceName = Instance.Name.ToString();
+
+		Instance.bPassesFilter = false;
+		for (const FString& Pattern : FilterPatterns)
+		{
+			if (InstanceName.MatchesWildcard(Pattern, ESearchCase::IgnoreCase))
+			{
+				Instance.bPassesFilter = true;
+				break;
+			}
+		}
+		Instance.FilterGeneration = FilterGeneration;
+	}
+
+	return Instance.bPassesFilter;
+}
+
+void FUEDebuggerInstances::SetFilter(const FString& Filter)
+{
+	check(IsInGameThread());
+
+	static const TCHAR* Delimiters[] = { TEXT("|"), TEXT(","), TEXT(" ") };
+
+	TArray<FString> Patterns;
+	Filter.ParseIntoArray(Patterns, Delimiters, UE_ARRAY_COUNT(Delimiters), true);
+
+	FilterPatterns.Reset();
+	for (const FString& Pattern : Patterns)
+	{
+		if (Pattern == TEXT("*") || Pattern.Equals(TEXT("All"), ESearchCase::IgnoreCase))
+		{
+			FilterPatterns.Reset();
+			break;
+		}
+		FilterPatterns.Add(Pattern);
+	}
+
+	FilterString = FString::Join(FilterPatterns, TEXT("|"));
+	FilterGeneration++;
+}
@@ -0,0 +1,86 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include <atomic>
+
+class UWorld;
+
+/**
+ * Breakpoint state of one PIE instance (server or client), or of the world of the editor or of a standalone game.
+ * With a server and several clients in PIE, each instance numbers its hits separately.
+ */
+struct FUEDebuggerInstance
+{
+	/** "Server", "Client1", "Client2"..., "Standalone", "Editor", or "Global" for the objects without world. */
+	FName Name;
+
+	/** PIE instance of the world (FWorldContext::PIEInstance), INDEX_NONE out of PIE. */
+	int32 PIEInstance = INDEX_NONE;
+
+	/** Index of the next hit of this instance, printed as [FrameCounter(Index)]. */
+	std::atomic<int64> NextHitIndex{ 0 };
+
+	/** Whether Name passes "UEDebugger.BreakpointFilter", valid for FilterGeneration. */
+	bool bPassesFilter = true;
+	int32 FilterGeneration = INDEX_NONE;
+};
+
+/**
+ * The instances of the breakpoints of "UEDebugger.BreakpointType 1", by world, and the filter of Console command
+ *     "UEDebugger.BreakpointFilter Server|Client2"
+ * which skips the hits of the other instances before any capture work.
+ * An instance is dropped with its world, so a new PIE session numbers its hits from 0.
+ */
+class FUEDebuggerInstances
+{
+public:
+
+	static FUEDebuggerInstances& Get();
+
+	/** Bind the cleanup of the worlds, called by FUEDebuggerEditorModule. */
+	void Initialize();
+
+	void Shutdown();
+
+	/** Game thread only. Never nullptr, the objects without world share the "Global" instance. */
+	FUEDebuggerInstance& FindOrAdd(const UObject* ActiveObject);
+
+	/** Game thread only. Whether the instance of ActiveObject passes the filter, as cheap as a lookup of the last world. */
+	bool PassesFilter(const UObject* ActiveObject);
+
+	/**
+	 * @param Filter	Instance names or wildcards separated by '|', ',' or spaces, e.g. "Server|Client2" or "Client*".
+	 *					Empty, "*" or "All" passes all instances.
+	 */
+	void SetFilter(const FString& Filter);
+
+	const FString& GetFilter() const { return FilterString; }
+
+private:
+
+	static FName GetInstanceName(UWorld* World, int32& OutPIEInstance);
+
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+private:
+
+	/** [World] = Instance, nullptr for the objects without world. */
+	TMap<const UWorld*, TUniquePtr<FUEDebuggerInstance>> Instances;
+
+	/** Most hits of a frame come from the same world. */
+	const UWorld* LastWorld = nullptr;
+	FUEDebuggerInstance* LastInstance = nullptr;
+
+	FString FilterString;
+
+	/** Empty if all instances pass. */
+	TArray<FString> FilterPatterns;
+
+	/** Increased when the filter changes, so the instances match their name again. */
+	int32 FilterGeneration = 0;
+
+	FDelegateHandle OnWorldCleanupHandle;
+};
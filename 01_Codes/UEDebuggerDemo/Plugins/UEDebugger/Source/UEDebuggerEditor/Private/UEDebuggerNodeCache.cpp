@@ -0,0 +1,80 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerNodeCache.h"
+#include "Editor.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphNode.h"
+#include "Kismet2/KismetDebugUtilities.h"
+
+FUEDebuggerNodeCache& FUEDebuggerNodeCache::Get()
+{
+	static FUEDebuggerNodeCache Singleton;
+	return Singleton;
+}
+
+void FUEDebuggerNodeCache::Initialize()
+{
+	if (GEditor)
+	{
+		OnBlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddRaw(this, &FUEDebuggerNodeCache::Invalidate);
+	}
+	OnPostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FUEDebuggerNodeCache::Invalidate);
+}
+
+void FUEDebuggerNodeCache::Shutdown()
+{
+	if (GEditor)
+	{
+		GEditor->OnBlueprintCompiled().Remove(OnBlueprintCompiledHandle);
+	}
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(OnPostGarbageCollectHandle);
+
+	OnBlueprintCompiledHandle.Reset();
+	OnPostGarbageCollectHandle.Reset();
+
+	Invalidate();
+}
+
+void FUEDebuggerNodeCache::Invalidate()
+{
+	CachedNodes.Reset();
+}
+
+const FUEDebuggerCachedNode* FUEDebuggerNodeCache::FindOrResolve(const UObject* ActiveObject, UFunction* Function, int32 CodeOffset)
+{
+	const FKey Key(Function, CodeOffset);
+
+	if (const FUEDebuggerCachedNode* CachedNode = CachedNodes.Find(Key))
+	{
+		// The function may have been replaced by a new one at the same address.
+		if (CachedNode->Function.Get() == Function && (CachedNode->Node.IsValid() || CachedNode->Node.IsExplicitlyNull()))
+		{
+			return CachedNode->Node.IsValid() ? CachedNode : nullptr;
+		}
+	}
+
+	FUEDebuggerCachedNode& CachedNode = CachedNodes.Add(Key);
+	CachedNode.Function = Function;
+
+	// Find the node that generated the code which we hit
+	UEdGraphNode* Node = FKismetDebugUtilities::FindSourceNodeForCodeLocation(ActiveObject, Function, CodeOffset, /*bAllowImpreciseHit=*/ true);
+	if (!Node)
+	{
+		return nullptr;
+	}
+
+	CachedNode.Node = Node;
+
+	if (Node->GetGraph())
+	{
+		CachedNode.NodeGraphNameString = Node->GetGraph()->GetName();
+	}
+
+	CachedNode.NodeNameString = Node->GetDescriptiveCompiledName();
+	CachedNode.NodeTitleString = Node->GetNodeTitle(ENodeTitleType::ListView).ToString();
+	CachedNode.NodeUniqueIDString = FString::Printf(TEXT("%d"), Node->GetUniqueID());
+
+	CachedNode.NodeCustomFullNameString = CachedNode.NodeTitleString + TEXT("(") + CachedNode.NodeUniqueIDString + TEXT(")");
+
+	return &CachedNode;
+}
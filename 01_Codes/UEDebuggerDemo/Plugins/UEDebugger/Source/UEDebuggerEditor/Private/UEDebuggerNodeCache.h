@@ -0,0 +1,60 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UEdGraphNode;
+class UFunction;
+
+/**
+ * Node which generated the bytecode at an offset of a function, resolved once.
+ */
+struct FUEDebuggerCachedNode
+{
+	TWeakObjectPtr<UFunction> Function;
+
+	TWeakObjectPtr<UEdGraphNode> Node;
+
+	FString NodeGraphNameString;
+
+	FString NodeNameString;
+	FString NodeTitleString;
+	FString NodeUniqueIDString;
+	FString NodeCustomFullNameString; // Use this for Print.
+};
+
+/**
+ * Cache of FKismetDebugUtilities::FindSourceNodeForCodeLocation() and of the names of the found node, keyed by (UFunction*, bytecode offset).
+ * Invalidated when a Blueprint is compiled and after garbage collection, so repeated hits of a node cost a single hash lookup.
+ */
+class FUEDebuggerNodeCache
+{
+public:
+
+	static FUEDebuggerNodeCache& Get();
+
+	/** Bind the invalidation delegates, called by FUEDebuggerEditorModule. */
+	void Initialize();
+
+	void Shutdown();
+
+	/**
+	 * @return nullptr if no node generated the code at CodeOffset. Only valid until the next call.
+	 */
+	const FUEDebuggerCachedNode* FindOrResolve(const UObject* ActiveObject, UFunction* Function, int32 CodeOffset);
+
+	void Invalidate();
+
+private:
+
+	typedef TPair<const UFunction*, int32> FKey;
+
+	/** [(Function, CodeOffset)] = Node, Node is null if no node generated the code. */
+	TMap<FKey, FUEDebuggerCachedNode> CachedNodes;
+
+	FDelegateHandle OnBlueprintCompiledHandle;
+
+	FDelegateHandle OnPostGarbageCollectHandle;
+};
@@ -0,0 +1,268 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerProfiler.h"
+#include "UEDebuggerEditor.h"
+#include "UEDebuggerNodeCache.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/Script.h"
+#include "UObject/Stack.h"
+
+static_assert((FUEDebuggerProfiler::Capacity & (FUEDebuggerProfiler::Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+static FAutoConsoleCommand CCmdProfileReport(
+	TEXT("UEDebugger.ProfileReport"),
+	TEXT("Arguments: [N] [Filename.csv] / Reset\n")
+	TEXT("Writes the N most expensive nodes profiled with \"UEDebugger.BreakpointType 2\" to the log (all by default), and to Filename.csv if specified.\n")
+	TEXT("Reset: clear the stats."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() == 1 && Args[0].Equals(TEXT("Reset"), ESearchCase::IgnoreCase))
+			{
+				FUEDebuggerProfiler::Get().Reset();
+				UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("UEDebugger.ProfileReport: stats cleared"));
+				return;
+			}
+
+			const int32 NumNodes = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 0;
+			FUEDebuggerProfiler::Get().Report(NumNodes, Args.IsValidIndex(1) ? Args[1] : FString());
+		}));
+
+FUEDebuggerProfiler& FUEDebuggerProfiler::Get()
+{
+	static FUEDebuggerProfiler Singleton;
+	return Singleton;
+}
+
+FUEDebuggerProfiler::FUEDebuggerProfiler()
+	: Slots(MakeUnique<FSlot[]>(Capacity))
+	, NumOverflowHits(0)
+	, TlsSlot(FPlatformTLS::AllocTlsSlot())
+{
+}
+
+FUEDebuggerProfiler::~FUEDebuggerProfiler()
+{
+	FPlatformTLS::FreeTlsSlot(TlsSlot);
+
+	for (FThreadProbes* Probes : ThreadProbes)
+	{
+		delete Probes;
+	}
+	ThreadProbes.Empty();
+}
+
+void FUEDebuggerProfiler::OnScriptException(const UObject* ActiveObject, const FFrame& StackFrame, const FBlueprintExceptionInfo& Info)
+{
+	if (!ActiveObject || Info.GetType() != EBlueprintExceptionType::Breakpoint)
+	{
+		return;
+	}
+
+	Get().RecordHit(ActiveObject, StackFrame);
+}
+
+FUEDebuggerProfiler::FThreadProbes& FUEDebuggerProfiler::GetProbesOfCurrentThread()
+{
+	FThreadProbes* Probes = static_cast<FThreadProbes*>(FPlatformTLS::GetTlsValue(TlsSlot));
+	if (!Probes)
+	{
+		Probes = new FThreadProbes();
+		FPlatformTLS::SetTlsValue(TlsSlot, Probes);
+
+		FScopeLock ScopeLock(&ThreadProbesCriticalSection);
+		ThreadProbes.Add(Probes);
+	}
+	return *Probes;
+}
+
+int32 FUEDebuggerProfiler::FindOrAddSlot(const UObject* ActiveObject, UFunction* Function, int32 CodeOffset)
+{
+	// Never 0, which marks a free slot.
+	const uint64 Key = (uint64(UPTRINT(Function)) ^ (uint64(uint32(CodeOffset)) << 40) ^ uint64(uint32(CodeOffset))) | 1;
+
+	uint32 SlotIndex = GetTypeHash(Key) & (Capacity - 1);
+	for (int32 NumProbed = 0; NumProbed < Capacity; NumProbed++, SlotIndex = (SlotIndex + 1) & (Capacity - 1))
+	{
+		FSlot& Slot = Slots[SlotIndex];
+
+		uint64 SlotKey = Slot.Key.load(std::memory_order_acquire);
+		if (SlotKey == 0)
+		{
+			if (Slot.Key.compare_exchange_strong(SlotKey, Key, std::memory_order_acq_rel))
+			{
+				Slot.FunctionPtr = Function;
+				Slot.Function = Function;
+				Slot.ActiveObject = ActiveObject;
+				Slot.CodeOffset = CodeOffset;
+				Slot.bPublished.store(true, std::memory_order_release);
+				return int32(SlotIndex);
+			}
+			// Claimed by another thread, SlotKey is its key now.
+		}
+
+		if (SlotKey == Key)
+		{
+			while (!Slot.bPublished.load(std::memory_order_acquire))
+			{
+				FPlatformProcess::Yield();
+			}
+			if (Slot.FunctionPtr == Function && Slot.CodeOffset == CodeOffset)
+			{
+				return int32(SlotIndex);
+			}
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void FUEDebuggerProfiler::RecordHit(const UObject* ActiveObject, const FFrame& StackFrame)
+{
+	const uint64 NowCycles = FPlatformTime::Cycles64();
+
+	UFunction* Function = StackFrame.Node;
+	const int32 CodeOffset = StackFrame.Code - Function->Script.GetData() - 1;
+
+	const int32 SlotIndex = FindOrAddSlot(ActiveObject, Function, CodeOffset);
+	if (SlotIndex == INDEX_NONE)
+	{
+		NumOverflowHits.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	Slots[SlotIndex].NumHits.fetch_add(1, std::memory_order_relaxed);
+
+	const int32 Depth = FBlueprintContextTracker::Get().GetScriptStack().Num();
+	if (Depth >= MaxTrackedDepth)
+	{
+		return;
+	}
+
+	// The time since the previous hit in the same invocation of this graph belongs to the previous node.
+	FProbe& Probe = GetProbesOfCurrentThread().Probes[Depth];
+	if (Probe.SlotIndex != INDEX_NONE && Probe.Function == Function && Probe.Locals == StackFrame.Locals && Probe.FrameCounter == GFrameCounter)
+	{
+		FSlot& PreviousSlot = Slots[Probe.SlotIndex];
+		const uint64 DeltaCycles = NowCycles - Probe.Cycles;
+
+		PreviousSlot.NumTimedHits.fetch_add(1, std::memory_order_relaxed);
+		PreviousSlot.InclusiveCycles.fetch_add(DeltaCycles, std::memory_order_relaxed);
+
+		uint64 MaxCycles = PreviousSlot.MaxCycles.load(std::memory_order_relaxed);
+		while (DeltaCycles > MaxCycles && !PreviousSlot.MaxCycles.compare_exchange_weak(MaxCycles, DeltaCycles, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	Probe.Function = Function;
+	Probe.Locals = StackFrame.Locals;
+	Probe.SlotIndex = SlotIndex;
+	Probe.FrameCounter = GFrameCounter;
+
+	// Excludes the cost of this function from the next delta.
+	Probe.Cycles = FPlatformTime::Cycles64();
+}
+
+void FUEDebuggerProfiler::Report(int32 NumNodes, const FString& Filename)
+{
+	TArray<const FSlot*> UsedSlots;
+	for (int32 SlotIndex = 0; SlotIndex < Capacity; SlotIndex++)
+	{
+		const FSlot& Slot = Slots[SlotIndex];
+		if (Slot.bPublished.load(std::memory_order_acquire))
+		{
+			UsedSlots.Add(&Slot);
+		}
+	}
+
+	// Most expensive first, then most hit.
+	UsedSlots.Sort([](const FSlot& A, const FSlot& B)
+		{
+			const uint64 CyclesA = A.InclusiveCycles.load(std::memory_order_relaxed);
+			const uint64 CyclesB = B.InclusiveCycles.load(std::memory_order_relaxed);
+			return CyclesA != CyclesB ? CyclesA > CyclesB : A.NumHits.load(std::memory_order_relaxed) > B.NumHits.load(std::memory_order_relaxed);
+		});
+
+	const int32 NumToReport = NumNodes > 0 ? FMath::Min(NumNodes, UsedSlots.Num()) : UsedSlots.Num();
+
+	FString FileContent = TEXT("Graph,Node,Function,CodeOffset,Hits,TimedHits,InclusiveMs,AverageUs,MaxUs") LINE_TERMINATOR;
+
+	UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("=================== UEDebugger Profile: %d of %d nodes, %lld hits not recorded ==================="), NumToReport, UsedSlots.Num(), NumOverflowHits.load(std::memory_order_relaxed));
+	UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("%10s %10s %12s %10s %10s  Node"), TEXT("Hits"), TEXT("Timed"), TEXT("Incl ms"), TEXT("Avg us"), TEXT("Max us"));
+
+	for (int32 Rank = 0; Rank < NumToReport; Rank++)
+	{
+		const FSlot& Slot = *UsedSlots[Rank];
+
+		const UObject* ActiveObject = Slot.ActiveObject.Get();
+		UFunction* Function = Slot.Function.Get();
+
+		FString GraphString;
+		FString NodeString;
+		if (ActiveObject && Function)
+		{
+			if (const FUEDebuggerCachedNode* CachedNode = FUEDebuggerNodeCache::Get().FindOrResolve(ActiveObject, Function, Slot.CodeOffset))
+			{
+				GraphString = CachedNode->NodeGraphNameString;
+				NodeString = CachedNode->NodeCustomFullNameString;
+			}
+		}
+
+		const int64 NumHits = Slot.NumHits.load(std::memory_order_relaxed);
+		const int64 NumTimedHits = Slot.NumTimedHits.load(std::memory_order_relaxed);
+		const double InclusiveMs = FPlatformTime::ToMilliseconds64(Slot.InclusiveCycles.load(std::memory_order_relaxed));
+		const double AverageUs = NumTimedHits > 0 ? InclusiveMs * 1000.0 / double(NumTimedHits) : 0.0;
+		const double MaxUs = FPlatformTime::ToMilliseconds64(Slot.MaxCycles.load(std::memory_order_relaxed)) * 1000.0;
+
+		UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("%10lld %10lld %12.3f %10.2f %10.2f  %s.\"%s\" (%s+%d)"),
+			NumHits, NumTimedHits, InclusiveMs, AverageUs, MaxUs, *GraphString, *NodeString, *GetNameSafe(Function), Slot.CodeOffset);
+
+		if (!Filename.IsEmpty())
+		{
+			FileContent += FString::Printf(TEXT("\"%s\",\"%s\",\"%s\",%d,%lld,%lld,%.3f,%.2f,%.2f") LINE_TERMINATOR,
+				*GraphString.Replace(TEXT("\""), TEXT("\"\"")),
+				*NodeString.Replace(TEXT("\""), TEXT("\"\"")),
+				*GetNameSafe(Function),
+				Slot.CodeOffset,
+				NumHits,
+				NumTimedHits,
+				InclusiveMs,
+				AverageUs,
+				MaxUs);
+		}
+	}
+
+	if (!Filename.IsEmpty())
+	{
+		FFileHelper::SaveStringToFile(FileContent, *Filename);
+	}
+}
+
+void FUEDebuggerProfiler::Reset()
+{
+	check(IsInGameThread());
+
+	for (int32 SlotIndex = 0; SlotIndex < Capacity; SlotIndex++)
+	{
+		FSlot& Slot = Slots[SlotIndex];
+		Slot.bPublished.store(false, std::memory_order_relaxed);
+		Slot.FunctionPtr = nullptr;
+		Slot.Function.Reset();
+		Slot.ActiveObject.Reset();
+		Slot.CodeOffset = INDEX_NONE;
+		Slot.NumHits.store(0, std::memory_order_relaxed);
+		Slot.NumTimedHits.store(0, std::memory_order_relaxed);
+		Slot.InclusiveCycles.store(0, std::memory_order_relaxed);
+		Slot.MaxCycles.store(0, std::memory_order_relaxed);
+		Slot.Key.store(0, std::memory_order_release);
+	}
+	NumOverflowHits.store(0, std::memory_order_relaxed);
+
+	FScopeLock ScopeLock(&ThreadProbesCriticalSection);
+	for (FThreadProbes* Probes : ThreadProbes)
+	{
+		*Probes = FThreadProbes();
+	}
+}
@@ -0,0 +1,115 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "Templates/UniquePtr.h"
+#include <atomic>
+
+struct FFrame;
+struct FBlueprintExceptionInfo;
+
+/**
+ * Node-level profiler of Blueprints, enabled with "UEDebugger.BreakpointType 2": the breakpoints print nothing,
+ * every hit only stores a cycle timestamp and updates the stats of its node.
+ *
+ * The time between two consecutive hits in the same invocation of a graph is added to the inclusive time of the first node,
+ * so put breakpoints on the nodes to measure and on the node following them.
+ * Console command "UEDebugger.ProfileReport [N] [Filename.csv]" prints the N most expensive nodes, "UEDebugger.ProfileReport Reset" clears the stats.
+ *
+ * The stats are a fixed-size open-addressing table keyed by (UFunction*, bytecode offset): slots are claimed with a compare-and-swap,
+ * counters are atomics, so recording never takes a lock nor allocates. Node names are only resolved by the report.
+ */
+class FUEDebuggerProfiler
+{
+public:
+
+	/** Number of slots of the stats table. Must be a power of two. */
+	static constexpr int32 Capacity = 8192;
+
+	/** Script stack depth tracked for the time between consecutive hits. */
+	static constexpr int32 MaxTrackedDepth = 32;
+
+	static FUEDebuggerProfiler& Get();
+
+	~FUEDebuggerProfiler();
+
+	/** Bound to FBlueprintCoreDelegates::OnScriptException by "UEDebugger.BreakpointType 2". */
+	static void OnScriptException(const UObject* ActiveObject, const FFrame& StackFrame, const FBlueprintExceptionInfo& Info);
+
+	void RecordHit(const UObject* ActiveObject, const FFrame& StackFrame);
+
+	/**
+	 * Writes the most expensive nodes to the log.
+	 * @param NumNodes	0 for all the nodes.
+	 * @param Filename	Also written as CSV to this file if not empty.
+	 */
+	void Report(int32 NumNodes, const FString& Filename);
+
+	/** Game thread only, while no hit is recorded. */
+	void Reset();
+
+private:
+
+	FUEDebuggerProfiler();
+
+	struct FSlot
+	{
+		/** 0 while the slot is free. */
+		std::atomic<uint64> Key{ 0 };
+
+		/** Set once Function, ActiveObject and CodeOffset are written by the thread which claimed the slot. */
+		std::atomic<bool> bPublished{ false };
+
+		const UFunction* FunctionPtr = nullptr;
+		TWeakObjectPtr<UFunction> Function;
+
+		/** First object which hit the node, needed to resolve the node. */
+		TWeakObjectPtr<const UObject> ActiveObject;
+
+		int32 CodeOffset = INDEX_NONE;
+
+		std::atomic<int64> NumHits{ 0 };
+
+		/** Number of hits followed by another hit in the same invocation of the graph. */
+		std::atomic<int64> NumTimedHits{ 0 };
+
+		std::atomic<uint64> InclusiveCycles{ 0 };
+		std::atomic<uint64> MaxCycles{ 0 };
+	};
+
+	/** Last hit of a depth of the script stack, per thread. */
+	struct FProbe
+	{
+		const UFunction* Function = nullptr;
+		const uint8* Locals = nullptr;
+		int32 SlotIndex = INDEX_NONE;
+		uint64 Cycles = 0;
+		uint64 FrameCounter = 0;
+	};
+
+	struct FThreadProbes
+	{
+		FProbe Probes[MaxTrackedDepth];
+	};
+
+	/** @return INDEX_NONE if the table is full. */
+	int32 FindOrAddSlot(const UObject* ActiveObject, UFunction* Function, int32 CodeOffset);
+
+	FThreadProbes& GetProbesOfCurrentThread();
+
+private:
+
+	TUniquePtr<FSlot[]> Slots;
+
+	/** Number of hits not recorded because the table is full. */
+	std::atomic<int64> NumOverflowHits;
+
+	uint32 TlsSlot;
+
+	/** Probes of all threads, they live until the profiler is destroyed. */
+	TArray<FThreadProbes*> ThreadProbes;
+
+	FCriticalSection ThreadProbesCriticalSection;
+};
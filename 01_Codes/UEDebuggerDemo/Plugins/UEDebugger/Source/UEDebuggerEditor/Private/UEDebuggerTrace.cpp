@@ -0,0 +1,600 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerTrace.h"
+#include "UEDebuggerEditor.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/Paths.h"
+#include "UEDebuggerScriptStacks.h"
+#include "UEDebuggerPinValues.h"
+#include "UObject/UnrealType.h"
+
+void UEDebuggerTrace::WriteVarUInt(TArray<uint8>& Out, uint64 Value)
+{
+	do
+	{
+		uint8 Byte = Value & 0x7f;
+		Value >>= 7;
+		if (Value != 0)
+		{
+			Byte |= 0x80;
+		}
+		Out.Add(Byte);
+	} while (Value != 0);
+}
+
+void UEDebuggerTrace::WriteVarInt(TArray<uint8>& Out, int64 Value)
+{
+	// ZigZag, so small negative deltas stay small.
+	WriteVarUInt(Out, (uint64(Value) << 1) ^ uint64(Value >> 63));
+}
+
+bool UEDebuggerTrace::ReadVarUInt(const TArray<uint8>& Data, int32& InOutOffset, uint64& OutValue)
+{
+	OutValue = 0;
+	for (int32 Shift = 0; Shift < 64; Shift += 7)
+	{
+		if (!Data.IsValidIndex(InOutOffset))
+		{
+			return false;
+		}
+
+		const uint8 Byte = Data[InOutOffset++];
+		OutValue |= uint64(Byte & 0x7f) << Shift;
+		if ((Byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UEDebuggerTrace::ReadVarInt(const TArray<uint8>& Data, int32& InOutOffset, int64& OutValue)
+{
+	uint64 Value = 0;
+	if (!ReadVarUInt(Data, InOutOffset, Value))
+	{
+		return false;
+	}
+	OutValue = int64(Value >> 1) ^ -int64(Value & 1);
+	return true;
+}
+
+static FAutoConsoleCommand CCmdBreakpointTrace(
+	TEXT("UEDebugger.BreakpointTrace"),
+	TEXT("Arguments: Start [Filename] / Stop\n")
+	TEXT("Start: Write the hits of \"UEDebugger.BreakpointType 1\" into a binary trace instead of the log, default file is Saved/Logs/UEDebugger-<Timestamp>.uedtrace.\n")
+	TEXT("Stop: Close the trace. Convert it with the commandlet \"-run=UEDebuggerTrace -Input=<Filename>\"."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() > 0 && Args[0].Equals(TEXT("Start"), ESearchCase::IgnoreCase))
+			{
+				FUEDebuggerTraceWriter::Get().Start(Args.IsValidIndex(1) ? Args[1] : FString());
+			}
+			else if (Args.Num() > 0 && Args[0].Equals(TEXT("Stop"), ESearchCase::IgnoreCase))
+			{
+				FUEDebuggerTraceWriter::Get().Stop();
+			}
+			else
+			{
+				UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("UEDebugger.BreakpointTrace is %s %s"), FUEDebuggerTraceWriter::Get().IsActive() ? TEXT("writing") : TEXT("stopped"), *FUEDebuggerTraceWriter::Get().GetFilename());
+			}
+		}));
+
+FUEDebuggerTraceWriter& FUEDebuggerTraceWriter::Get()
+{
+	static FUEDebuggerTraceWriter Singleton;
+	return Singleton;
+}
+
+FUEDebuggerTraceWriter::FUEDebuggerTraceWriter()
+	: FileWriter(nullptr)
+	, PreviousFrameCounter(0)
+	, PreviousIndex(0)
+	, PreviousCycles(0)
+{
+}
+
+FUEDebuggerTraceWriter::~FUEDebuggerTraceWriter()
+{
+	Stop();
+}
+
+bool FUEDebuggerTraceWriter::Start(const FString& InFilename)
+{
+	Stop();
+
+	Filename = InFilename.IsEmpty() ? FPaths::ProjectLogDir() / FString::Printf(TEXT("UEDebugger-%s.uedtrace"), *FDateTime::Now().ToString()) : InFilename;
+	FileWriter = IFileManager::Get().CreateFileWriter(*Filename);
+	if (!FileWriter)
+	{
+		UE_LOG(LogUEDebuggerEditorModule, Error, TEXT("UEDebugger.BreakpointTrace failed to create %s"), *Filename);
+		return false;
+	}
+
+	uint32 HeaderMagic = UEDebuggerTrace::Magic;
+	uint32 HeaderVersion = UEDebuggerTrace::Version;
+	int64 StartTicks = FDateTime::Now().GetTicks();
+	*FileWriter << HeaderMagic;
+	*FileWriter << HeaderVersion;
+	*FileWriter << StartTicks;
+
+	Block.Reset(BlockSize + 1024);
+	StringIds.Reset();
+	StringIds.Add(FString(), 0);
+	ScriptStackStringIds.Reset();
+	PinNameIds.Reset();
+	PreviousFrameCounter = 0;
+	PreviousIndex = 0;
+	PreviousCycles = FPlatformTime::Cycles64();
+
+	UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("UEDebugger.BreakpointTrace started: %s"), *Filename);
+	return true;
+}
+
+void FUEDebuggerTraceWriter::Stop()
+{
+	if (!FileWriter)
+	{
+		return;
+	}
+
+	FlushBlock();
+	FileWriter->Close();
+	delete FileWriter;
+	FileWriter = nullptr;
+
+	StringIds.Empty();
+	ScriptStackStringIds.Empty();
+	PinNameIds.Empty();
+	Block.Empty();
+
+	UE_LOG(LogUEDebuggerEditorModule, Log, TEXT("UEDebugger.BreakpointTrace stopped: %s"), *Filename);
+}
+
+uint32 FUEDebuggerTraceWriter::InternString(const FString& String)
+{
+	if (const uint32* Id = StringIds.Find(String))
+	{
+		return *Id;
+	}
+
+	const uint32 Id = StringIds.Num();
+	StringIds.Add(String, Id);
+
+	const FTCHARToUTF8 Utf8String(*String);
+	Block.Add(UEDebuggerTrace::Record_String);
+	UEDebuggerTrace::WriteVarUInt(Block, Id);
+	UEDebuggerTrace::WriteVarUInt(Block, Utf8String.Length());
+	Block.Append(reinterpret_cast<const uint8*>(Utf8String.Get()), Utf8String.Length());
+
+	return Id;
+}
+
+uint32 FUEDebuggerTraceWriter::InternPinName(FName DisplayName, const FProperty* Property)
+{
+	if (const uint32* Id = PinNameIds.Find(DisplayName))
+	{
+		return *Id;
+	}
+
+	const uint32 Id = InternString(FName::NameToDisplayString(DisplayName.ToString(), CastField<FBoolProperty>(Property) != nullptr));
+	PinNameIds.Add(DisplayName, Id);
+	return Id;
+}
+
+FUEDebuggerTraceWriter::FScriptStackStringIds FUEDebuggerTraceWriter::InternScriptStack(const FBlueprintExceptionDebugInfo& Info)
+{
+	if (const FScriptStackStringIds* Ids = ScriptStackStringIds.Find(Info.StackId))
+	{
+		return *Ids;
+	}
+
+	const FUEDebuggerScriptStackText* Text = FUEDebuggerScriptStacks::Get().FindText(Info.StackId);
+
+	FScriptStackStringIds Ids;
+	Ids.PreFrameNameId = InternString(Text ? Text->RootDescription : Info.PreFrameNameString);
+	Ids.StackTraceId = InternString(Text ? Text->StackTrace : Info.StackTraceString);
+	Ids.ScriptCallstackId = InternString(Text ? Text->ScriptCallstack : Info.ScriptCallstackString);
+	Ids.StackDescriptionId = InternString(Text ? Text->StackDescription : Info.StackDescriptionString);
+
+	// Without stack (e.g. a hit read from a trace), the strings of the hit are not cached.
+	if (Text)
+	{
+		ScriptStackStringIds.Add(Info.StackId, Ids);
+	}
+	return Ids;
+}
+
+void FUEDebuggerTraceWriter::WriteInlineString(const TCHAR* String, int32 Length)
+{
+	const FTCHARToUTF8 Utf8String(String, Length);
+	UEDebuggerTrace::WriteVarUInt(Block, Utf8String.Length());
+	Block.Append(reinterpret_cast<const uint8*>(Utf8String.Get()), Utf8String.Length());
+}
+
+void FUEDebuggerTraceWriter::WritePins(const FBlueprintExceptionDebugInfo& Info, EUEDebuggerPinKind Kind, const TArray<FString>& PinStrings)
+{
+	const FUEDebuggerPinValues* PinValues = Info.PinValues.Get();
+
+	int32 NumPins = PinStrings.Num();
+	if (PinValues)
+	{
+		for (int32 PinIndex = 0; PinIndex < PinValues->Num(); PinIndex++)
+		{
+			NumPins += PinValues->GetKind(PinIndex) == Kind ? 1 : 0;
+		}
+	}
+	UEDebuggerTrace::WriteVarUInt(Block, NumPins);
+
+	// The texts of a hit without raw values are written whole.
+	for (const FString& PinString : PinStrings)
+	{
+		UEDebuggerTrace::WriteVarUInt(Block, 0);
+		WriteInlineString(*PinString, PinString.Len());
+	}
+
+	if (PinValues)
+	{
+		for (int32 PinIndex = 0; PinIndex < PinValues->Num(); PinIndex++)
+		{
+			if (PinValues->GetKind(PinIndex) != Kind)
+			{
+				continue;
+			}
+
+			// Values rarely repeat (positions, timers), they are not interned. The name was interned before the hit record.
+			PinValueText.Reset();
+			PinValues->AppendValueText(PinValueText, PinIndex);
+			UEDebuggerTrace::WriteVarUInt(Block, InternPinName(PinValues->GetDisplayName(PinIndex), PinValues->GetProperty(PinIndex)));
+			WriteInlineString(PinValueText.GetData(), PinValueText.Len());
+		}
+	}
+}
+
+void FUEDebuggerTraceWriter::WriteHit(const FBlueprintExceptionDebugInfo& Info)
+{
+	if (!FileWriter)
+	{
+		return;
+	}
+
+	// Strings are defined before the hit which uses them.
+	const FScriptStackStringIds StackIds = InternScriptStack(Info);
+	const uint32 FieldIds[] =
+	{
+		InternString(Info.ActiveObjectNameString),
+		StackIds.PreFrameNameId,
+		InternString(Info.NodeGraphNameString),
+		InternString(Info.NodeNameString),
+		InternString(Info.NodeTitleString),
+		InternString(Info.NodeUniqueIDString),
+		InternString(Info.NodeCustomFullNameString),
+		StackIds.StackTraceId,
+		StackIds.ScriptCallstackId,
+		StackIds.StackDescriptionId,
+		InternString(Info.OwnerNameString),
+		InternString(Info.InstigatorNameString),
+		InternString(Info.InstigatorControllerNameString),
+	};
+
+	if (const FUEDebuggerPinValues* PinValues = Info.PinValues.Get())
+	{
+		for (int32 PinIndex = 0; PinIndex < PinValues->Num(); PinIndex++)
+		{
+			InternPinName(PinValues->GetDisplayName(PinIndex), PinValues->GetProperty(PinIndex));
+		}
+	}
+
+	const uint64 Cycles = FPlatformTime::Cycles64();
+	const uint64 Microseconds = uint64(FPlatformTime::ToSeconds64(Cycles - PreviousCycles) * 1000000.0);
+
+	Block.Add(UEDebuggerTrace::Record_Hit);
+	UEDebuggerTrace::WriteVarInt(Block, Info.FrameCounter - PreviousFrameCounter);
+	UEDebuggerTrace::WriteVarInt(Block, Info.Index - PreviousIndex);
+	UEDebuggerTrace::WriteVarUInt(Block, Microseconds);
+	for (uint32 Id : FieldIds)
+	{
+		UEDebuggerTrace::WriteVarUInt(Block, Id);
+	}
+	WritePins(Info, EUEDebuggerPinKind::Watched, Info.WatchedPinsStrings);
+	WritePins(Info, EUEDebuggerPinKind::Input, Info.InputParametersStrings);
+	WritePins(Info, EUEDebuggerPinKind::Output, Info.OutputParametersStrings);
+	UEDebuggerTrace::WriteVarUInt(Block, uint64(FMath::Max<int64>(Info.SuppressedHits, 0)));
+
+	PreviousFrameCounter = Info.FrameCounter;
+	PreviousIndex = Info.Index;
+	// Only advance by the written microseconds, so the rounding does not drift.
+	PreviousCycles += uint64(Microseconds / (FPlatformTime::GetSecondsPerCycle64() * 1000000.0));
+
+	if (Block.Num() >= BlockSize)
+	{
+		FlushBlock();
+	}
+}
+
+void FUEDebuggerTraceWriter::FlushBlock()
+{
+	if (!FileWriter || Block.Num() == 0)
+	{
+		return;
+	}
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Block.Num());
+	TArray<uint8> CompressedBlock;
+	CompressedBlock.SetNumUninitialized(CompressedSize);
+
+	const bool bCompressed = FCompression::CompressMemory(NAME_Zlib, CompressedBlock.GetData(), CompressedSize, Block.GetData(), Block.Num()) && CompressedSize < Block.Num();
+
+	TArray<uint8> BlockHeader;
+	UEDebuggerTrace::WriteVarUInt(BlockHeader, Block.Num());
+	UEDebuggerTrace::WriteVarUInt(BlockHeader, bCompressed ? CompressedSize : 0);
+	FileWriter->Serialize(BlockHeader.GetData(), BlockHeader.Num());
+
+	if (bCompressed)
+	{
+		FileWriter->Serialize(CompressedBlock.GetData(), CompressedSize);
+	}
+	else
+	{
+		FileWriter->Serialize(Block.GetData(), Block.Num());
+	}
+	FileWriter->Flush();
+
+	Block.Reset();
+}
+
+FUEDebuggerTraceReader::FUEDebuggerTraceReader()
+	: FileReader(nullptr)
+	, BlockOffset(0)
+	, FileVersion(0)
+	, FrameCounter(0)
+	, Index(0)
+	, Microseconds(0)
+	, bError(false)
+{
+}
+
+FUEDebuggerTraceReader::~FUEDebuggerTraceReader()
+{
+	delete FileReader;
+}
+
+bool FUEDebuggerTraceReader::Open(const FString& Filename)
+{
+	delete FileReader;
+	FileReader = IFileManager::Get().CreateFileReader(*Filename);
+	if (!FileReader)
+	{
+		bError = true;
+		return false;
+	}
+
+	uint32 HeaderMagic = 0;
+	uint32 HeaderVersion = 0;
+	int64 StartTicks = 0;
+	*FileReader << HeaderMagic;
+	*FileReader << HeaderVersion;
+	*FileReader << StartTicks;
+
+	if (FileReader->IsError() || HeaderMagic != UEDebuggerTrace::Magic || HeaderVersion > UEDebuggerTrace::Version)
+	{
+		bError = true;
+		return false;
+	}
+
+	StartTime = FDateTime(StartTicks);
+	FileVersion = HeaderVersion;
+	Strings.Reset();
+	Strings.Add(FString());
+	Block.Reset();
+	BlockOffset = 0;
+	return true;
+}
+
+bool FUEDebuggerTraceReader::ReadNextBlock()
+{
+	if (!FileReader || FileReader->AtEnd())
+	{
+		return false;
+	}
+
+	// The block header is read byte per byte, it is at most 2 varints.
+	auto ReadFileVarUInt = [this](uint64& OutValue)
+	{
+		OutValue = 0;
+		for (int32 Shift = 0; Shift < 64 && !FileReader->AtEnd(); Shift += 7)
+		{
+			uint8 Byte = 0;
+			FileReader->Serialize(&Byte, 1);
+			OutValue |= uint64(Byte & 0x7f) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				return !FileReader->IsError();
+			}
+		}
+		return false;
+	};
+
+	uint64 UncompressedSize = 0;
+	uint64 CompressedSize = 0;
+	if (!ReadFileVarUInt(UncompressedSize) || !ReadFileVarUInt(CompressedSize) || UncompressedSize > MAX_int32 || CompressedSize > MAX_int32)
+	{
+		bError = true;
+		return false;
+	}
+
+	Block.SetNumUninitialized(int32(UncompressedSize));
+	BlockOffset = 0;
+
+	if (CompressedSize == 0)
+	{
+		FileReader->Serialize(Block.GetData(), Block.Num());
+	}
+	else
+	{
+		TArray<uint8> CompressedBlock;
+		CompressedBlock.SetNumUninitialized(int32(CompressedSize));
+		FileReader->Serialize(CompressedBlock.GetData(), CompressedBlock.Num());
+
+		if (!FileReader->IsError() && !FCompression::UncompressMemory(NAME_Zlib, Block.GetData(), Block.Num(), CompressedBlock.GetData(), CompressedBlock.Num()))
+		{
+			bError = true;
+			return false;
+		}
+	}
+
+	bError = FileReader->IsError();
+	return !bError;
+}
+
+bool FUEDebuggerTraceReader::ReadStringId(FString& OutString)
+{
+	uint64 Id = 0;
+	if (!UEDebuggerTrace::ReadVarUInt(Block, BlockOffset, Id) || !Strings.IsValidIndex(int32(Id)))
+	{
+		return false;
+	}
+	OutString = Strings[int32(Id)];
+	return true;
+}
+
+bool FUEDebuggerTraceReader::ReadStringIds(TArray<FString>& OutStrings)
+{
+	uint64 Count = 0;
+	if (!UEDebuggerTrace::ReadVarUInt(Block, BlockOffset, Count) || Count > uint64(Block.Num()))
+	{
+		return false;
+	}
+
+	OutStrings.SetNum(int32(Count));
+	for (FString& String : OutStrings)
+	{
+		if (!ReadStringId(String))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FUEDebuggerTraceReader::ReadPins(TArray<FString>& OutStrings)
+{
+	uint64 Count = 0;
+	if (!UEDebuggerTrace::ReadVarUInt(Block, BlockOffset, Count) || Count > uint64(Block.Num()))
+	{
+		return false;
+	}
+
+	OutStrings.SetNum(int32(Count));
+	for (FString& String : OutStrings)
+	{
+		uint64 NameId = 0;
+		uint64 Length = 0;
+		if (!UEDebuggerTrace::ReadVarUInt(Block, BlockOffset, NameId) || !Strings.IsValidIndex(int32(NameId))
+			|| !UEDebuggerTrace::ReadVarUInt(Block, BlockOffset, Length) || Length > uint64(Block.Num() - BlockOffset))
+		{
+			return false;
+		}
+
+		const FUTF8ToTCHAR Value(reinterpret_cast<const ANSICHAR*>(Block.GetData() + BlockOffset), int32(Length));
+		BlockOffset += int32(Length);
+
+		if (NameId == 0)
+		{
+			String = FString(Value.Length(), Value.Get());
+		}
+		else
+		{
+			TStringBuilder<256> PinString;
+			PinString << TEXT("\"") << Strings[int32(NameId)] << TEXT("\" = \"");
+			PinString.Append(Value.Get(), Value.Length());
+			PinString << TEXT("\"");
+			String = FString(PinString.Len(), PinString.GetData());
+		}
+	}
+	return true;
+}
+
+bool FUEDebuggerTraceReader::ReadNextHit(FBlueprintExceptionDebugInfo& OutInfo)
+{
+	while (!bError)
+	{
+		if (BlockOffset >= Block.Num() && !ReadNextBlock())
+		{
+			return false;
+		}
+		if (BlockOffset >= Block.Num())
+		{
+			continue;
+		}
+
+		const uint8 RecordType = Block[BlockOffset++];
+		if (RecordType == UEDebuggerTrace::Record_String)
+		{
+			uint64 Id = 0;
+			uint64 Length = 0;
+			if (!UEDebuggerTrace::ReadVarUInt(Block, BlockOffset, Id) || !UEDebuggerTrace::ReadVarUInt(Block, BlockOffset, Length)
+				|| Id != uint64(Strings.Num()) || Length > uint64(Block.Num() - BlockOffset))
+			{
+				bError = true;
+				return false;
+			}
+
+			const FUTF8ToTCHAR String(reinterpret_cast<const ANSICHAR*>(Block.GetData() + BlockOffset), int32(Length));
+			Strings.Emplace(String.Length(), String.Get());
+			BlockOffset += int32(Length);
+		}
+		else if (RecordType == UEDebuggerTrace::Record_Hit)
+		{
+			int64 FrameDelta = 0;
+			int64 IndexDelta = 0;
+			uint64 MicrosecondsDelta = 0;
+			bool bValid = UEDebuggerTrace::ReadVarInt(Block, BlockOffset, FrameDelta)
+				&& UEDebuggerTrace::ReadVarInt(Block, BlockOffset, IndexDelta)
+				&& UEDebuggerTrace::ReadVarUInt(Block, BlockOffset, MicrosecondsDelta);
+
+			FrameCounter += FrameDelta;
+			Index += IndexDelta;
+			Microseconds += MicrosecondsDelta;
+
+			OutInfo = FBlueprintExceptionDebugInfo();
+			OutInfo.FrameCounter = FrameCounter;
+			OutInfo.FrameCounterString = FString::Printf(TEXT("%lld"), FrameCounter);
+			OutInfo.Index = Index;
+			OutInfo.IndexString = FString::Printf(TEXT("%lld"), Index);
+			OutInfo.TimestampString = (StartTime + FTimespan::FromMicroseconds(double(Microseconds))).ToString(TEXT("%m/%d/%y %H:%M:%S.%s"));
+
+			bValid = bValid
+				&& ReadStringId(OutInfo.ActiveObjectNameString)
+				&& ReadStringId(OutInfo.PreFrameNameString)
+				&& ReadStringId(OutInfo.NodeGraphNameString)
+				&& ReadStringId(OutInfo.NodeNameString)
+				&& ReadStringId(OutInfo.NodeTitleString)
+				&& ReadStringId(OutInfo.NodeUniqueIDString)
+				&& ReadStringId(OutInfo.NodeCustomFullNameString)
+				&& ReadStringId(OutInfo.StackTraceString)
+				&& ReadStringId(OutInfo.ScriptCallstackString)
+				&& ReadStringId(OutInfo.StackDescriptionString)
+				&& ReadStringId(OutInfo.OwnerNameString)
+				&& ReadStringId(OutInfo.InstigatorNameString)
+				&& ReadStringId(OutInfo.InstigatorControllerNameString)
+				&& (FileVersion < 3 ? ReadStringIds(OutInfo.WatchedPinsStrings) : ReadPins(OutInfo.WatchedPinsStrings))
+				&& (FileVersion < 3 ? ReadStringIds(OutInfo.InputParametersStrings) : ReadPins(OutInfo.InputParametersStrings))
+				&& (FileVersion < 3 ? ReadStringIds(OutInfo.OutputParametersStrings) : ReadPins(OutInfo.OutputParametersStrings));
+
+			uint64 SuppressedHits = 0;
+			bValid = bValid && (FileVersion < 2 || UEDebuggerTrace::ReadVarUInt(Block, BlockOffset, SuppressedHits));
+			OutInfo.SuppressedHits = int64(SuppressedHits);
+
+			bError = !bValid;
+			return bValid;
+		}
+		else
+		{
+			bError = true;
+			return false;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,183 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UEDebuggerBPLibrary.h"
+
+/**
+ * Binary append-only trace of the breakpoint hits, written instead of the text of "UEDebugger.BreakpointType 1" in the log.
+ *
+ * File layout:
+ *     Header: Magic (uint32), Version (uint32), Start time (FDateTime ticks, int64).
+ *     Blocks: UncompressedSize (varint), CompressedSize (varint, 0 if the block is stored), Bytes.
+ * The records of the blocks are:
+ *     String: Type (uint8), Id (varint), Length (varint), UTF-8 bytes. Id 0 is the empty string.
+ *             Only the strings which repeat are interned (names of objects, graphs, nodes and pins, stacks), each one is written once.
+ *     Hit:    Type (uint8), Frame delta (zigzag varint), Index delta (zigzag varint), Microseconds since previous hit (varint),
+ *             the string Ids of the fields of FBlueprintExceptionDebugInfo, then the watched, input and output pins,
+ *             then SuppressedHits (varint, since version 2).
+ *     Pins:   Count (varint), then per pin the Id of its name and its value inline: Length (varint), UTF-8 bytes (since version 3).
+ *             A pin without name Id (0) is the whole "Name" = "Value" text. Before version 3, Count (varint) + Ids of the pin texts.
+ *
+ * Convert a trace to text or JSON lines with the commandlet: "-run=UEDebuggerTrace -Input=File.uedtrace".
+ */
+namespace UEDebuggerTrace
+{
+	static const uint32 Magic = 0x54444555; // "UEDT"
+	/** 2: SuppressedHits after the pins of a hit. 3: Pin values inline, only their names interned. */
+	static const uint32 Version = 3;
+
+	enum ERecordType : uint8
+	{
+		Record_String = 1,
+		Record_Hit = 2,
+	};
+
+	void WriteVarUInt(TArray<uint8>& Out, uint64 Value);
+
+	void WriteVarInt(TArray<uint8>& Out, int64 Value);
+
+	/** @return false if Data is truncated. */
+	bool ReadVarUInt(const TArray<uint8>& Data, int32& InOutOffset, uint64& OutValue);
+
+	bool ReadVarInt(const TArray<uint8>& Data, int32& InOutOffset, int64& OutValue);
+}
+
+/**
+ * Writes the breakpoint hits of the game thread into a trace file.
+ */
+class FUEDebuggerTraceWriter
+{
+public:
+
+	/** Blocks are compressed and written when they reach this size. */
+	static const int32 BlockSize = 64 * 1024;
+
+	static FUEDebuggerTraceWriter& Get();
+
+	~FUEDebuggerTraceWriter();
+
+	/** @param Filename	Empty for "Saved/Logs/UEDebugger-<Timestamp>.uedtrace". */
+	bool Start(const FString& Filename);
+
+	void Stop();
+
+	bool IsActive() const
+	{
+		return FileWriter != nullptr;
+	}
+
+	const FString& GetFilename() const
+	{
+		return Filename;
+	}
+
+	void WriteHit(const FBlueprintExceptionDebugInfo& Info);
+
+private:
+
+	FUEDebuggerTraceWriter();
+
+	uint32 InternString(const FString& String);
+
+	/** Pin names are interned once per name, as FUEDebuggerPinValues::AppendPinString() displays them. */
+	uint32 InternPinName(FName DisplayName, const FProperty* Property);
+
+	struct FScriptStackStringIds
+	{
+		uint32 PreFrameNameId;
+		uint32 StackTraceId;
+		uint32 ScriptCallstackId;
+		uint32 StackDescriptionId;
+	};
+
+	/** The strings of a script stack of FUEDebuggerScriptStacks, interned once per stack. */
+	FScriptStackStringIds InternScriptStack(const FBlueprintExceptionDebugInfo& Info);
+
+	void WriteInlineString(const TCHAR* String, int32 Length);
+
+	/** The pins of Kind, from the raw values of the hit if it has them, otherwise from PinStrings. */
+	void WritePins(const FBlueprintExceptionDebugInfo& Info, EUEDebuggerPinKind Kind, const TArray<FString>& PinStrings);
+
+	void FlushBlock();
+
+private:
+
+	FArchive* FileWriter;
+
+	FString Filename;
+
+	/** Records not written yet. */
+	TArray<uint8> Block;
+
+	/** [String] = Id */
+	TMap<FString, uint32> StringIds;
+
+	/** [StackId] = Ids of the strings of the stack */
+	TMap<uint32, FScriptStackStringIds> ScriptStackStringIds;
+
+	/** [Pin name] = Id */
+	TMap<FName, uint32> PinNameIds;
+
+	/** Scratch builder of the pin values. */
+	TStringBuilder<1024> PinValueText;
+
+	int64 PreviousFrameCounter;
+	int64 PreviousIndex;
+	uint64 PreviousCycles;
+};
+
+/**
+ * Reads the breakpoint hits of a trace file.
+ */
+class FUEDebuggerTraceReader
+{
+public:
+
+	FUEDebuggerTraceReader();
+
+	~FUEDebuggerTraceReader();
+
+	bool Open(const FString& Filename);
+
+	/** @return false at the end of the trace or if it is corrupted, see IsError(). */
+	bool ReadNextHit(FBlueprintExceptionDebugInfo& OutInfo);
+
+	bool IsError() const
+	{
+		return bError;
+	}
+
+private:
+
+	bool ReadNextBlock();
+
+	bool ReadStringId(FString& OutString);
+
+	bool ReadStringIds(TArray<FString>& OutStrings);
+
+	/** Pins of version 3, rebuilt as "Name" = "Value". */
+	bool ReadPins(TArray<FString>& OutStrings);
+
+private:
+
+	FArchive* FileReader;
+
+	TArray<uint8> Block;
+
+	int32 BlockOffset;
+
+	/** [Id] = String */
+	TArray<FString> Strings;
+
+	FDateTime StartTime;
+
+	uint32 FileVersion;
+
+	int64 FrameCounter;
+	int64 Index;
+	uint64 Microseconds;
+
+	bool bError;
+};
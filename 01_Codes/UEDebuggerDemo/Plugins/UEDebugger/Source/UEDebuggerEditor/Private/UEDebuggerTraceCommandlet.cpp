@@ -0,0 +1,104 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerTraceCommandlet.h"
+#include "UEDebuggerEditor.h"
+#include "UEDebuggerTrace.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "JsonObjectConverter.h"
+
+UUEDebuggerTraceCommandlet::UUEDebuggerTraceCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UUEDebuggerTraceCommandlet::Main(const FString& Params)
+{
+	FString InputFilename;
+	if (!FParse::Value(*Params, TEXT("Input="), InputFilename))
+	{
+		UE_LOG(LogUEDebuggerEditorModule, Error, TEXT("Usage: -run=UEDebuggerTrace -Input=Trace.uedtrace [-Output=File] [-Format=Text|Json] [-Node=Wildcard] [-Graph=Wildcard] [-MinFrame=N] [-MaxFrame=N]"));
+		return 1;
+	}
+
+	FString Format = TEXT("Text");
+	FParse::Value(*Params, TEXT("Format="), Format);
+	const bool bJson = Format.Equals(TEXT("Json"), ESearchCase::IgnoreCase);
+
+	FString OutputFilename = FPaths::ChangeExtension(InputFilename, bJson ? TEXT("jsonl") : TEXT("txt"));
+	FParse::Value(*Params, TEXT("Output="), OutputFilename);
+
+	FString NodeFilter;
+	FString GraphFilter;
+	FParse::Value(*Params, TEXT("Node="), NodeFilter);
+	FParse::Value(*Params, TEXT("Graph="), GraphFilter);
+
+	int64 MinFrame = MIN_int64;
+	int64 MaxFrame = MAX_int64;
+	FParse::Value(*Params, TEXT("MinFrame="), MinFrame);
+	FParse::Value(*Params, TEXT("MaxFrame="), MaxFrame);
+
+	FUEDebuggerTraceReader Reader;
+	if (!Reader.Open(InputFilename))
+	{
+		UE_LOG(LogUEDebuggerEditorModule, Error, TEXT("%s is not a UEDebugger trace."), *InputFilename);
+		return 1;
+	}
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*OutputFilename));
+	if (!Writer)
+	{
+		UE_LOG(LogUEDebuggerEditorModule, Error, TEXT("Failed to create %s"), *OutputFilename);
+		return 1;
+	}
+
+	int32 NumHits = 0;
+	int32 NumWrittenHits = 0;
+	FBlueprintExceptionDebugInfo Info;
+	while (Reader.ReadNextHit(Info))
+	{
+		NumHits++;
+
+		if (Info.FrameCounter < MinFrame || Info.FrameCounter > MaxFrame)
+		{
+			continue;
+		}
+		if (!GraphFilter.IsEmpty() && !Info.NodeGraphNameString.MatchesWildcard(GraphFilter))
+		{
+			continue;
+		}
+		if (!NodeFilter.IsEmpty() && !Info.NodeTitleString.MatchesWildcard(NodeFilter) && !Info.NodeNameString.MatchesWildcard(NodeFilter) && !Info.NodeCustomFullNameString.MatchesWildcard(NodeFilter))
+		{
+			continue;
+		}
+
+		FString Line;
+		if (bJson)
+		{
+			FJsonObjectConverter::UStructToJsonObjectString(Info, Line, 0, 0, 0, nullptr, /*bPrettyPrint=*/ false);
+		}
+		else
+		{
+			Line = Info.ToLogString();
+		}
+		Line += TEXT("\n");
+
+		const FTCHARToUTF8 Utf8Line(*Line);
+		Writer->Serialize(const_cast<ANSICHAR*>(Utf8Line.Get()), Utf8Line.Length());
+		NumWrittenHits++;
+	}
+
+	Writer->Close();
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogUEDebuggerEditorModule, Warning, TEXT("%s is truncated or corrupted, stopped after %d hits."), *InputFilename, NumHits);
+	}
+
+	UE_LOG(LogUEDebuggerEditorModule, Display, TEXT("Wrote %d of %d hits to %s"), NumWrittenHits, NumHits, *OutputFilename);
+	return 0;
+}
@@ -0,0 +1,23 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UEDebuggerTraceCommandlet.generated.h"
+
+/**
+ * Converts a breakpoint trace of "UEDebugger.BreakpointTrace" to text or JSON lines. Runs headless, e.g.
+ *     UE4Editor-Cmd Project.uproject -run=UEDebuggerTrace -Input=Trace.uedtrace [-Output=Trace.txt] [-Format=Text|Json]
+ *         [-Node=Wildcard] [-Graph=Wildcard] [-MinFrame=N] [-MaxFrame=N]
+ * -Node matches the title, the name or the print name of the node. Without -Output, the result is written next to the input.
+ */
+UCLASS()
+class UUEDebuggerTraceCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
@@ -0,0 +1,135 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "UEDebuggerWatchedPins.h"
+#include "Editor.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphNode.h"
+#include "Engine/Blueprint.h"
+#include "Kismet2/KismetDebugUtilities.h"
+
+static TAutoConsoleVariable<int32> CVarWatchedPinsScope(
+	TEXT("UEDebugger.WatchedPinsScope"),
+	0,
+	TEXT("Watched pins printed by the breakpoints of \"UEDebugger.BreakpointType 1\".\n")
+	TEXT("0: the watched pins of the node and of the nodes linked to its inputs.\n")
+	TEXT("1: the watched pins of the graph of the node.\n")
+	TEXT("2: all the watched pins of the Blueprint."),
+	ECVF_Default);
+
+FUEDebuggerWatchedPins& FUEDebuggerWatchedPins::Get()
+{
+	static FUEDebuggerWatchedPins Singleton;
+	return Singleton;
+}
+
+void FUEDebuggerWatchedPins::Initialize()
+{
+	OnWatchedPinsListChangedHandle = FKismetDebugUtilities::WatchedPinsListChangedEvent.AddRaw(this, &FUEDebuggerWatchedPins::OnWatchedPinsListChanged);
+	if (GEditor)
+	{
+		OnBlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddRaw(this, &FUEDebuggerWatchedPins::Invalidate);
+	}
+	OnPostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FUEDebuggerWatchedPins::Invalidate);
+}
+
+void FUEDebuggerWatchedPins::Shutdown()
+{
+	FKismetDebugUtilities::WatchedPinsListChangedEvent.Remove(OnWatchedPinsListChangedHandle);
+	if (GEditor)
+	{
+		GEditor->OnBlueprintCompiled().Remove(OnBlueprintCompiledHandle);
+	}
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(OnPostGarbageCollectHandle);
+
+	OnWatchedPinsListChangedHandle.Reset();
+	OnBlueprintCompiledHandle.Reset();
+	OnPostGarbageCollectHandle.Reset();
+
+	Invalidate();
+}
+
+void FUEDebuggerWatchedPins::Invalidate()
+{
+	Indices.Reset();
+}
+
+void FUEDebuggerWatchedPins::OnWatchedPinsListChanged(UBlueprint* Blueprint)
+{
+	Indices.Remove(Blueprint);
+}
+
+void FUEDebuggerWatchedPins::BuildIndex(UBlueprint* Blueprint, FBlueprintIndex& Index) const
+{
+	Index.Blueprint = Blueprint;
+	Index.NumWatchedPins = Blueprint->WatchedPins.Num();
+	Index.AllPins.Reset();
+	Index.PinsByNode.Reset();
+	Index.PinsByGraph.Reset();
+
+	for (const FEdGraphPinReference& PinReference : Blueprint->WatchedPins)
+	{
+		const UEdGraphPin* Pin = PinReference.Get();
+		const UEdGraphNode* OwningNode = Pin ? Pin->GetOwningNodeUnchecked() : nullptr;
+		if (!OwningNode)
+		{
+			continue;
+		}
+
+		FUEDebuggerWatchedPin WatchedPin;
+		WatchedPin.PinReference = PinReference;
+		WatchedPin.Property = FKismetDebugUtilities::FindClassPropertyForPin(Blueprint, Pin);
+		if (!WatchedPin.Property)
+		{
+			continue;
+		}
+
+		Index.AllPins.Add(WatchedPin);
+		Index.PinsByGraph.FindOrAdd(OwningNode->GetGraph()).Add(WatchedPin);
+		Index.PinsByNode.FindOrAdd(OwningNode).Add(WatchedPin);
+
+		// The nodes which read the outputs of the watched node, e.g. the watches of a pure node are relevant to the node using its result.
+		TArray<const UEdGraphNode*, TInlineAllocator<8>> LinkedNodes;
+		for (const UEdGraphPin* OwningNodePin : OwningNode->Pins)
+		{
+			if (!OwningNodePin || OwningNodePin->Direction != EGPD_Output)
+			{
+				continue;
+			}
+
+			for (const UEdGraphPin* LinkedPin : OwningNodePin->LinkedTo)
+			{
+				const UEdGraphNode* LinkedNode = LinkedPin ? LinkedPin->GetOwningNodeUnchecked() : nullptr;
+				if (LinkedNode && LinkedNode != OwningNode && !LinkedNodes.Contains(LinkedNode))
+				{
+					LinkedNodes.Add(LinkedNode);
+					Index.PinsByNode.FindOrAdd(LinkedNode).Add(WatchedPin);
+				}
+			}
+		}
+	}
+}
+
+const TArray<FUEDebuggerWatchedPin>& FUEDebuggerWatchedPins::Find(UBlueprint* Blueprint, const UEdGraphNode* Node)
+{
+	if (!Blueprint || Blueprint->WatchedPins.Num() == 0)
+	{
+		return EmptyPins;
+	}
+
+	FBlueprintIndex& Index = Indices.FindOrAdd(Blueprint);
+	if (Index.Blueprint.Get() != Blueprint || Index.NumWatchedPins != Blueprint->WatchedPins.Num())
+	{
+		BuildIndex(Blueprint, Index);
+	}
+
+	const int32 Scope = CVarWatchedPinsScope.GetValueOnGameThread();
+	if (Scope >= 2)
+	{
+		return Index.AllPins;
+	}
+
+	const TArray<FUEDebuggerWatchedPin>* Pins = Scope == 1
+		? (Node ? Index.PinsByGraph.Find(Node->GetGraph()) : nullptr)
+		: Index.PinsByNode.Find(Node);
+	return Pins ? *Pins : EmptyPins;
+}
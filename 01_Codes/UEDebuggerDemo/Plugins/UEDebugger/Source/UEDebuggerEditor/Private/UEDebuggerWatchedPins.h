@@ -0,0 +1,77 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EdGraph/EdGraphPin.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UBlueprint;
+class UEdGraph;
+class UEdGraphNode;
+
+/** A watched pin of a Blueprint, with its property found once by FKismetDebugUtilities::FindClassPropertyForPin(). */
+struct FUEDebuggerWatchedPin
+{
+	FEdGraphPinReference PinReference;
+
+	const FProperty* Property = nullptr;
+};
+
+/**
+ * Index of the watched pins of the Blueprints, so a breakpoint hit only captures the watches relevant to its node, as set by
+ *     "UEDebugger.WatchedPinsScope 0/1/2"
+ * 0: the watched pins of the node and of the nodes linked to its inputs. 1: the watched pins of the graph of the node. 2: all the watched pins of the Blueprint.
+ * The index of a Blueprint is built at its first hit, and dropped when its watches change, when a Blueprint is compiled and after garbage collection.
+ */
+class FUEDebuggerWatchedPins
+{
+public:
+
+	static FUEDebuggerWatchedPins& Get();
+
+	/** Bind the invalidation delegates, called by FUEDebuggerEditorModule. */
+	void Initialize();
+
+	void Shutdown();
+
+	/** The watched pins of Blueprint to capture for a hit of Node, in the scope of "UEDebugger.WatchedPinsScope". Only valid until the next call. */
+	const TArray<FUEDebuggerWatchedPin>& Find(UBlueprint* Blueprint, const UEdGraphNode* Node);
+
+	void Invalidate();
+
+private:
+
+	struct FBlueprintIndex
+	{
+		TWeakObjectPtr<UBlueprint> Blueprint;
+
+		/** Number of watched pins when the index was built, a change not notified by the editor still rebuilds the index. */
+		int32 NumWatchedPins = 0;
+
+		TArray<FUEDebuggerWatchedPin> AllPins;
+
+		/** [Node] = Watched pins of the node and of the nodes linked to its inputs. */
+		TMap<const UEdGraphNode*, TArray<FUEDebuggerWatchedPin>> PinsByNode;
+
+		/** [Graph] = Watched pins of the graph. */
+		TMap<const UEdGraph*, TArray<FUEDebuggerWatchedPin>> PinsByGraph;
+	};
+
+	void BuildIndex(UBlueprint* Blueprint, FBlueprintIndex& Index) const;
+
+	void OnWatchedPinsListChanged(UBlueprint* Blueprint);
+
+private:
+
+	/** [Blueprint] = Index */
+	TMap<const UBlueprint*, FBlueprintIndex> Indices;
+
+	const TArray<FUEDebuggerWatchedPin> EmptyPins;
+
+	FDelegateHandle OnWatchedPinsListChangedHandle;
+
+	FDelegateHandle OnBlueprintCompiledHandle;
+
+	FDelegateHandle OnPostGarbageCollectHandle;
+};
@@ -5,6 +5,9 @@
 #include "Modules/ModuleInterface.h"
 #include "UEDebuggerBPLibrary.h"
 
+struct FFileChangeData;
+class UBlueprint;
+
 DECLARE_LOG_CATEGORY_EXTERN(LogUEDebuggerEditorModule, Log, All);
 
 class UEDEBUGGEREDITOR_API FUEDebuggerEditorModule : public IModuleInterface
@@ -20,4 +23,17 @@ public:
 	static void OnScriptExceptionCustom(const UObject* ActiveObject, const FFrame& StackFrame, const FBlueprintExceptionInfo& Info);
 
 	static bool GetBlueprintExceptionDebugInfo(const UObject* ActiveObject, const FFrame& StackFrame, const FBlueprintExceptionInfo& Info, FBlueprintExceptionDebugInfo& OutBlueprintExceptionDebugInfo);
+
+	/**
+	 * The container of Property, the property of a pin found by FKismetDebugUtilities::FindClassPropertyForPin(), as FKismetDebugUtilities::GetDebugInfo() does:
+	 * the locals of a function of the script stack, then the instance, then the persistent frame of the ubergraph. nullptr if not found.
+	 */
+	static void* FindPinPropertyContainer(const UBlueprint* Blueprint, UObject* BlueprintInstance, const FProperty* Property);
+
+private:
+
+	/** Reloads the ConsoleCommandGroups of [UEDebugger.ConsoleCommandGroups] when a Game ini of the project is saved. */
+	void OnProjectConfigDirectoryChanged(const TArray<FFileChangeData>& FileChanges);
+
+	FDelegateHandle ProjectConfigDirectoryChangedHandle;
 };
@@ -47,7 +47,10 @@ public class UEDebuggerEditor : ModuleRules
 				"UnrealEd",
 				"Projects",
                 "DetailCustomizations",
-				"PropertyEditor"
+				"PropertyEditor",
+				"Json",
+				"JsonUtilities",
+				"DirectoryWatcher"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);